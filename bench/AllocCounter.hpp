@@ -0,0 +1,11 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace ddc {
+
+// Heap allocations made by the process so far: AllocCounter.cpp replaces the global
+// operator new, so linking it in counts every allocation.
+extern std::atomic<uint64_t> g_allocCount;
+
+} // namespace ddc
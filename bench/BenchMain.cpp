@@ -0,0 +1,833 @@
+// Microbenchmarks for the hot path (correctness tests: tests/, run by ctest).
+// Usage: ddc_bench [iterations] [--json results.json] [--suite-only]
+//   --json        also write the suite results as JSON (for tracking regressions between releases)
+//   --suite-only  skip the legacy-vs-current comparison benches
+#include "Config.hpp"
+#include "ExtractionEngine.hpp"
+#include "ExtractionPool.hpp"
+#include "MessageParser.hpp"
+#include "SnapshotSerializer.hpp"
+#include "ImmediateEncoder.hpp"
+#include "BinaryEncoder.hpp"
+#include "BinaryDecoder.hpp"
+#include "CsvLogger.hpp"
+#include "LatencyStats.hpp"
+#include "Metrics.hpp"
+#include "BusAnalyzer.hpp"
+#include "AllocCounter.hpp"
+#include "Synthetic.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace ddc;
+
+namespace {
+
+// Reference copy of the original unordered_map + string-compare extraction path.
+class LegacyExtractor {
+public:
+    explicit LegacyExtractor(const AppConfig& cfg) {
+        for (const auto& stream : cfg.streams)
+            for (const auto& f : stream.fields) m_lookup[MsgKey{f.rt, f.subAddress, f.transmit}].push_back(f);
+    }
+
+    std::vector<ExtractedValue> process(const ParsedMessage& msg) {
+        std::vector<ExtractedValue> out;
+        auto it = m_lookup.find(MsgKey{msg.rt, msg.sa, msg.transmit});
+        if (it == m_lookup.end()) return out;
+        for (const auto& spec : it->second) {
+            int available = static_cast<int>(msg.data.size());
+            if (spec.startWord < 1 || spec.endWord < 1 || spec.startWord > available || spec.endWord > available)
+                continue;
+            ExtractedValue ev{spec.name, decode(spec, msg), spec.type, msg.timestamp};
+            out.push_back(ev);
+            m_latest[spec.name] = ev;
+        }
+        return out;
+    }
+
+    // Lookup + decode only, without building ExtractedValue records
+    double decodeOnly(const ParsedMessage& msg) const {
+        double sum = 0.0;
+        auto it = m_lookup.find(MsgKey{msg.rt, msg.sa, msg.transmit});
+        if (it == m_lookup.end()) return sum;
+        for (const auto& spec : it->second) {
+            int available = static_cast<int>(msg.data.size());
+            if (spec.startWord < 1 || spec.endWord < 1 || spec.startWord > available || spec.endWord > available)
+                continue;
+            sum += decode(spec, msg);
+        }
+        return sum;
+    }
+
+private:
+    static double decode(const FieldSpec& spec, const ParsedMessage& msg) {
+        double value = 0.0;
+        if (spec.singleBit) {
+            uint16_t word = msg.data[spec.startWord - 1];
+            if (spec.bit >= 0 && spec.bit < 16) value = ((word >> spec.bit) & 0x1);
+        } else if (spec.startWord == spec.endWord) {
+            uint16_t word = msg.data[spec.startWord - 1];
+            value = (spec.type == "signed") ? static_cast<double>(static_cast<int16_t>(word)) : word;
+        } else {
+            uint64_t accum = 0;
+            int n = spec.endWord - spec.startWord + 1;
+            for (int i = 0; i < n; i++) accum = (accum << 16) | msg.data[spec.startWord - 1 + i];
+            if (spec.type == "ieee754" && n == 2) {
+                uint32_t raw = static_cast<uint32_t>(accum & 0xFFFFFFFFu);
+                float f; std::memcpy(&f, &raw, sizeof(f));
+                value = static_cast<double>(f);
+            } else if (spec.type == "signed") {
+                int totalBits = n * 16;
+                uint64_t signMask = 1ull << (totalBits - 1);
+                value = static_cast<double>((accum & signMask) ? (static_cast<int64_t>(accum) - (1ll << totalBits))
+                                                               : static_cast<int64_t>(accum));
+            } else {
+                value = static_cast<double>(accum);
+            }
+        }
+        return value * spec.lsbScale;
+    }
+
+    std::unordered_map<MsgKey, std::vector<FieldSpec>, MsgKeyHash> m_lookup;
+    std::unordered_map<std::string, ExtractedValue> m_latest;
+};
+
+template <typename Msg, typename Fn>
+double nsPerMessage(const std::vector<Msg>& msgs, size_t iterations, Fn&& fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t it = 0; it < iterations; ++it)
+        for (const auto& m : msgs) fn(m);
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    return ns / static_cast<double>(msgs.size() * iterations);
+}
+
+void benchExtraction(size_t fieldCount, size_t keyCount, size_t iterations) {
+    AppConfig cfg = makeConfig(fieldCount, keyCount);
+    auto raws = makeMessages(cfg, 4096);
+    auto msgs = parseAll(raws);
+    LegacyExtractor legacy(cfg);
+    ExtractionEngine engine(cfg);
+
+    // Both paths must agree before timing them
+    for (const auto& m : msgs) {
+        auto a = legacy.process(m);
+        auto b = engine.process(m);
+        bool same = a.size() == b.size();
+        for (size_t i = 0; same && i < a.size(); ++i)
+            same = a[i].name == b[i].name && (a[i].numericValue == b[i].numericValue ||
+                                              (std::isnan(a[i].numericValue) && std::isnan(b[i].numericValue)));
+        if (!same) { std::cerr << "extract mismatch at " << m.rt << "-" << m.sa << "\n"; std::exit(1); }
+    }
+
+    size_t sink = 0;
+    double legacyNs = nsPerMessage(msgs, iterations, [&](const ParsedMessage& m) { sink += legacy.process(m).size(); });
+    double planNs = nsPerMessage(msgs, iterations, [&](const ParsedMessage& m) { sink += engine.process(m).size(); });
+    std::vector<FieldValue> buf(engine.maxValuesPerMessage());
+    double extractNs = nsPerMessage(msgs, iterations, [&](const ParsedMessage& m) { sink += engine.extract(m, buf.data(), buf.size()); });
+    MessageParser parser;
+    double parseExtractNs = nsPerMessage(raws, iterations, [&](const Raw1553Message& r) {
+        ParsedMessage p;
+        if (parser.parse(r, p)) sink += engine.extract(p, buf.data(), buf.size());
+    });
+    std::cout << "parse+extract fields=" << fieldCount << " keys=" << keyCount
+              << " ns_per_msg=" << parseExtractNs
+              << " msgs_per_sec=" << (1e9 / parseExtractNs) << "\n";
+    std::cout << "extract fields=" << fieldCount << " keys=" << keyCount
+              << " legacy_ns_per_msg=" << legacyNs
+              << " plan_ns_per_msg=" << planNs
+              << " zero_alloc_ns_per_msg=" << extractNs
+              << " speedup=" << (legacyNs / extractNs)
+              << " (" << sink << ")\n";
+
+    // Dispatch + decode only: isolates the table lookup from result allocation
+    ExtractionPlan plan(cfg);
+    double acc = 0.0;
+    double legacyDecodeNs = nsPerMessage(msgs, iterations, [&](const ParsedMessage& m) { acc += legacy.decodeOnly(m); });
+    double planDecodeNs = nsPerMessage(msgs, iterations, [&](const ParsedMessage& m) {
+        if (!msgKeyInRange(m.rt, m.sa)) return;
+        const DecodeSlot& slot = plan.slot(msgKeyIndex(m.rt, m.sa, m.transmit));
+        for (const DecodeOp* op = plan.ops() + slot.first, *end = op + slot.count; op != end; ++op)
+            if (op->minWords <= m.data.size()) acc += decodeField(*op, m.data.data());
+    });
+    std::cout << "decode fields=" << fieldCount << " keys=" << keyCount
+              << " legacy_ns_per_msg=" << legacyDecodeNs
+              << " plan_ns_per_msg=" << planDecodeNs
+              << " speedup=" << (legacyDecodeNs / planDecodeNs)
+              << " (" << (acc != 0.0) << ")\n";
+}
+
+// Batch snapshot: nlohmann DOM + dump() vs the precompiled serializer.
+void benchSnapshot(size_t fieldCount, size_t keyCount, size_t iterations) {
+    AppConfig cfg = makeConfig(fieldCount, keyCount);
+    auto raws = makeMessages(cfg, 4096);
+    auto msgs = parseAll(raws);
+    ExtractionEngine engine(cfg);
+    std::vector<FieldValue> buf(engine.maxValuesPerMessage());
+    // Populate roughly half of the keys first so partially-seen objects are covered
+    std::vector<std::string> names;
+    for (uint32_t id = 0; id < engine.fieldCount(); ++id) names.push_back(engine.fieldName(id));
+    SnapshotSerializer serializer(names);
+    ValueSnapshot snap;
+    std::string payload;
+    auto check = [&](uint64_t seq) {
+        // Retry across a wall-clock second boundary (datetime differs)
+        for (int attempt = 0; attempt < 3; ++attempt) {
+            auto j = engine.buildJsonSnapshot();
+            j["seq"] = seq;
+            std::string dom = j.dump();
+            engine.snapshot(snap);
+            serializer.serialize(snap, seq, payload);
+            if (dom == payload) return;
+        }
+        std::cerr << "snapshot mismatch\n" << payload << "\n";
+        std::exit(1);
+    };
+    check(0); // nothing seen yet
+    for (size_t i = 0; i < msgs.size() / 64; ++i) engine.extract(msgs[i], buf.data(), buf.size());
+    check(1);
+    for (const auto& m : msgs) engine.extract(m, buf.data(), buf.size());
+    check(2);
+
+    size_t bytes = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t it = 0; it < iterations; ++it) {
+        auto j = engine.buildJsonSnapshot();
+        j["seq"] = it;
+        bytes += j.dump().size();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (size_t it = 0; it < iterations; ++it) {
+        engine.snapshot(snap);
+        serializer.serialize(snap, it, payload);
+        bytes += payload.size();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    double domUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / static_cast<double>(iterations);
+    double tplUs = std::chrono::duration<double, std::micro>(t2 - t1).count() / static_cast<double>(iterations);
+    std::cout << "snapshot fields=" << fieldCount << " payload_bytes=" << payload.size()
+              << " dom_us_per_tick=" << domUs
+              << " serializer_us_per_tick=" << tplUs
+              << " speedup=" << (domUs / tplUs)
+              << " (" << bytes << ")\n";
+}
+
+// Previous immediate-mode payload: one nlohmann object per value.
+std::string legacyImmediate(const std::string& name, const FieldValue& ev, uint64_t seq) {
+    nlohmann::json j;
+    j["timestamp_us"] = ev.timestamp;
+    j["timestamp"] = static_cast<double>(ev.timestamp) / 1e6;
+    auto now = std::chrono::system_clock::now();
+    std::time_t t = std::chrono::system_clock::to_time_t(now);
+    auto tm = *std::gmtime(&t);
+    std::ostringstream oss;
+    oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%SZ");
+    j["datetime"] = oss.str();
+    j["seq"] = seq;
+    size_t start = 0;
+    nlohmann::json* cur = &j;
+    while (true) {
+        size_t dot = name.find('.', start);
+        std::string key = (dot == std::string::npos) ? name.substr(start) : name.substr(start, dot - start);
+        if (dot == std::string::npos) { (*cur)[key] = ev.value; break; }
+        cur = &((*cur)[key]);
+        start = dot + 1;
+    }
+    return j.dump();
+}
+
+// Immediate mode: per-value nlohmann object vs ImmediateEncoder.
+void benchImmediate(size_t fieldCount, size_t keyCount, size_t iterations) {
+    AppConfig cfg = makeConfig(fieldCount, keyCount);
+    auto raws = makeMessages(cfg, 1024);
+    auto msgs = parseAll(raws);
+    ExtractionEngine engine(cfg);
+    std::vector<FieldValue> buf(engine.maxValuesPerMessage());
+    std::vector<std::string> names;
+    for (uint32_t id = 0; id < engine.fieldCount(); ++id) names.push_back(engine.fieldName(id));
+    // Awkward names: metadata key clashes, escaping, empty segments
+    std::vector<std::string> edge = {"seq", "datetime", "zz.seq", "q\"uote.x", "a..b", "", "\u00e9t\u00e9.v"};
+    std::vector<std::string> all(names);
+    all.insert(all.end(), edge.begin(), edge.end());
+    ImmediateEncoder encoder(all);
+    std::string payload;
+    auto check = [&](const FieldValue& v, uint64_t seq) {
+        for (int attempt = 0; attempt < 3; ++attempt) {
+            std::string expected = legacyImmediate(all[v.fieldId], v, seq);
+            encoder.encode(v, seq, payload);
+            if (expected == payload) return;
+        }
+        std::cerr << "immediate mismatch\n" << payload << "\n";
+        std::exit(1);
+    };
+    uint64_t seq = 0;
+    for (const auto& m : msgs) {
+        size_t n = engine.extract(m, buf.data(), buf.size());
+        for (size_t i = 0; i < n; ++i) check(buf[i], seq++);
+    }
+    for (uint32_t id = static_cast<uint32_t>(names.size()); id < all.size(); ++id)
+        check(FieldValue{id, -1.5e-7, 1234567890123ull}, seq++);
+
+    size_t values = 0, bytes = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t it = 0; it < iterations; ++it) {
+        for (const auto& m : msgs) {
+            size_t n = engine.extract(m, buf.data(), buf.size());
+            for (size_t i = 0; i < n; ++i) bytes += legacyImmediate(names[buf[i].fieldId], buf[i], seq++).size();
+            values += n;
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (size_t it = 0; it < iterations; ++it) {
+        for (const auto& m : msgs) {
+            size_t n = engine.extract(m, buf.data(), buf.size());
+            for (size_t i = 0; i < n; ++i) { encoder.encode(buf[i], seq++, payload); bytes += payload.size(); }
+        }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    double legacyNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(values);
+    double encNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / static_cast<double>(values);
+    std::cout << "immediate fields=" << fieldCount
+              << " nlohmann_ns_per_value=" << legacyNs
+              << " encoder_ns_per_value=" << encNs
+              << " speedup=" << (legacyNs / encNs)
+              << " (" << bytes << ")\n";
+}
+
+// Binary format: lossless round trip through the reference decoder, then encode cost
+// and size against the JSON encoders.
+void benchBinary(size_t fieldCount, size_t keyCount, size_t iterations) {
+    AppConfig cfg = makeConfig(fieldCount, keyCount);
+    auto raws = makeMessages(cfg, 4096);
+    auto msgs = parseAll(raws);
+    ExtractionEngine engine(cfg);
+    std::vector<FieldValue> buf(engine.maxValuesPerMessage());
+    std::vector<std::string> names;
+    for (uint32_t id = 0; id < engine.fieldCount(); ++id) names.push_back(engine.fieldName(id));
+    SnapshotSerializer serializer(names);
+    ImmediateEncoder immediate(names);
+    BinaryEncoder encoder(engine.fields());
+    BinaryDecoder decoder;
+    ValueSnapshot snap;
+    std::string payload;
+    DecodedFrame frame;
+
+    auto fail = [](const char* what) { std::cerr << "binary round trip: " << what << "\n"; std::exit(1); };
+    auto same = [](double a, double b) { return a == b || (a != a && b != b); };
+    std::vector<std::string> fragments;
+    encoder.encodeSchema(0, fragments);
+    for (const auto& f : fragments) {
+        if (decoder.feed(reinterpret_cast<const uint8_t*>(f.data()), f.size(), frame) != BinaryDecoder::Result::Schema)
+            fail("schema fragment rejected");
+    }
+    if (!decoder.schemaComplete() || decoder.schemaId() != encoder.schemaId() || decoder.fieldCount() != names.size())
+        fail("schema incomplete");
+    for (uint32_t id = 0; id < names.size(); ++id)
+        if (decoder.fieldName(id) != names[id] || decoder.wireType(id) != encoder.wireType(id)) fail("schema entry");
+
+    // Default wire types are exact, so decoded values must equal the snapshot bit for bit
+    auto checkSnapshot = [&](uint64_t seq) {
+        engine.snapshot(snap);
+        encoder.encodeSnapshot(snap, seq, payload);
+        if (decoder.feed(reinterpret_cast<const uint8_t*>(payload.data()), payload.size(), frame) != BinaryDecoder::Result::Data)
+            fail("data rejected");
+        if (frame.seq != seq || frame.timestampUs != snap.latestTimestamp) fail("header");
+        size_t k = 0;
+        for (uint32_t id = 0; id < names.size(); ++id) {
+            if (!snap.valid[id]) continue;
+            if (k >= frame.values.size() || frame.values[k].fieldId != id || !same(frame.values[k].value, snap.values[id]))
+                fail("snapshot value");
+            ++k;
+        }
+        if (k != frame.values.size()) fail("extra values");
+    };
+    checkSnapshot(0);
+    for (size_t i = 0; i < msgs.size() / 64; ++i) engine.extract(msgs[i], buf.data(), buf.size());
+    checkSnapshot(1);
+    uint64_t seq = 2;
+    for (const auto& m : msgs) {
+        size_t n = engine.extract(m, buf.data(), buf.size());
+        for (size_t i = 0; i < n; ++i) {
+            encoder.encodeValue(buf[i], seq, payload);
+            if (decoder.feed(reinterpret_cast<const uint8_t*>(payload.data()), payload.size(), frame) != BinaryDecoder::Result::Data ||
+                frame.seq != seq || frame.timestampUs != buf[i].timestamp || frame.values.size() != 1 ||
+                frame.values[0].fieldId != buf[i].fieldId || !same(frame.values[0].value, buf[i].value))
+                fail("immediate value");
+            ++seq;
+        }
+    }
+    checkSnapshot(seq++);
+
+    // Snapshot encode cost and size
+    size_t jsonBytes = 0, binBytes = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t it = 0; it < iterations; ++it) {
+        engine.snapshot(snap);
+        serializer.serialize(snap, it, payload);
+        jsonBytes += payload.size();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (size_t it = 0; it < iterations; ++it) {
+        engine.snapshot(snap);
+        encoder.encodeSnapshot(snap, it, payload);
+        binBytes += payload.size();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    double jsonUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / static_cast<double>(iterations);
+    double binUs = std::chrono::duration<double, std::micro>(t2 - t1).count() / static_cast<double>(iterations);
+    std::cout << "binary snapshot fields=" << fieldCount
+              << " json_bytes=" << jsonBytes / iterations << " binary_bytes=" << binBytes / iterations
+              << " json_us_per_tick=" << jsonUs << " binary_us_per_tick=" << binUs
+              << " json_MBps=" << static_cast<double>(jsonBytes) / (jsonUs * static_cast<double>(iterations))
+              << " binary_MBps=" << static_cast<double>(binBytes) / (binUs * static_cast<double>(iterations)) << "\n";
+
+    // Immediate encode cost and size per value
+    size_t values = 0;
+    jsonBytes = binBytes = 0;
+    auto t3 = std::chrono::steady_clock::now();
+    for (const auto& m : msgs) {
+        size_t n = engine.extract(m, buf.data(), buf.size());
+        for (size_t i = 0; i < n; ++i) { immediate.encode(buf[i], seq++, payload); jsonBytes += payload.size(); }
+        values += n;
+    }
+    auto t4 = std::chrono::steady_clock::now();
+    for (const auto& m : msgs) {
+        size_t n = engine.extract(m, buf.data(), buf.size());
+        for (size_t i = 0; i < n; ++i) { encoder.encodeValue(buf[i], seq++, payload); binBytes += payload.size(); }
+    }
+    auto t5 = std::chrono::steady_clock::now();
+    std::cout << "binary immediate fields=" << fieldCount
+              << " json_bytes_per_value=" << static_cast<double>(jsonBytes) / static_cast<double>(values)
+              << " binary_bytes_per_value=" << static_cast<double>(binBytes) / static_cast<double>(values)
+              << " json_ns_per_value=" << std::chrono::duration<double, std::nano>(t4 - t3).count() / static_cast<double>(values)
+              << " binary_ns_per_value=" << std::chrono::duration<double, std::nano>(t5 - t4).count() / static_cast<double>(values) << "\n";
+}
+
+// Previous CsvLogger: every row formatted with ofstream << on the caller's thread.
+class LegacyCsvLogger {
+public:
+    bool open(const std::string& path) { m_ofs.open(path, std::ios::out | std::ios::trunc); return static_cast<bool>(m_ofs); }
+    void setColumns(const std::vector<std::string>& names) {
+        for (auto n : names) { for (auto& ch : n) if (ch == '.') ch = '/'; m_columns.push_back(n); }
+        m_lastValues.assign(names.size(), 0.0);
+        m_seen.assign(names.size(), false);
+    }
+    void writeValues(const FieldValue* values, size_t count) {
+        if (count == 0) return;
+        std::lock_guard<std::mutex> lk(m_mtx);
+        for (size_t i = 0; i < count; ++i) {
+            if (values[i].fieldId >= m_lastValues.size()) continue;
+            m_lastValues[values[i].fieldId] = values[i].value;
+            m_seen[values[i].fieldId] = true;
+        }
+        if (!m_headerWritten) {
+            m_ofs << "timestamp";
+            for (auto& col : m_columns) m_ofs << "," << col;
+            m_ofs << "\n";
+            m_headerWritten = true;
+        }
+        m_ofs << values[0].timestamp;
+        for (size_t c = 0; c < m_lastValues.size(); ++c) {
+            if (m_seen[c]) m_ofs << "," << m_lastValues[c]; else m_ofs << ",";
+        }
+        m_ofs << "\n";
+    }
+    void flush() { m_ofs.flush(); }
+
+private:
+    std::ofstream m_ofs;
+    std::mutex m_mtx;
+    bool m_headerWritten{false};
+    std::vector<std::string> m_columns;
+    std::vector<double> m_lastValues;
+    std::vector<bool> m_seen;
+};
+
+// CSV: caller-side cost per row (what the processing thread pays) for the old
+// synchronous logger vs the async one, plus a byte-equality check of the files.
+void benchCsv(size_t fieldCount, size_t keyCount, size_t rows) {
+    AppConfig cfg = makeConfig(fieldCount, keyCount);
+    auto raws = makeMessages(cfg, 4096);
+    auto msgs = parseAll(raws);
+    ExtractionEngine engine(cfg);
+    std::vector<std::string> names;
+    for (uint32_t id = 0; id < engine.fieldCount(); ++id) names.push_back(engine.fieldName(id));
+    // Pre-extract so only the logger is timed; add awkward doubles to the first message
+    std::vector<std::vector<FieldValue>> batches;
+    std::vector<FieldValue> buf(engine.maxValuesPerMessage());
+    for (const auto& m : msgs) {
+        size_t n = engine.extract(m, buf.data(), buf.size());
+        if (n) batches.emplace_back(buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(n));
+    }
+    const double specials[] = {-0.0, 1e-300, 123456789.0, 0.1, -2.5e17, std::nan(""), -INFINITY, 1e21};
+    for (size_t i = 0; i < std::size(specials) && i < batches.front().size(); ++i) batches.front()[i].value = specials[i];
+
+    auto dir = std::filesystem::temp_directory_path();
+    std::string legacyPath = (dir / "ddc_bench_legacy.csv").string();
+    std::string asyncPath = (dir / "ddc_bench_async.csv").string();
+    std::vector<uint32_t> latency(rows);
+    auto summarize = [&latency](double& mean, uint32_t& p99, uint32_t& max) {
+        double sum = 0;
+        for (auto l : latency) sum += l;
+        mean = sum / static_cast<double>(latency.size());
+        std::vector<uint32_t> sorted(latency);
+        std::sort(sorted.begin(), sorted.end());
+        p99 = sorted[sorted.size() * 99 / 100];
+        max = sorted.back();
+    };
+    auto timed = [&](auto& logger) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < rows; ++r) {
+            const auto& b = batches[r % batches.size()];
+            auto t0 = std::chrono::steady_clock::now();
+            logger.writeValues(b.data(), b.size());
+            auto t1 = std::chrono::steady_clock::now();
+            latency[r] = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        }
+        logger.flush();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    double legacySec, asyncSec, legacyMean, asyncMean;
+    uint32_t legacyP99, legacyMax, asyncP99, asyncMax;
+    {
+        LegacyCsvLogger legacy;
+        legacy.setColumns(names);
+        legacy.open(legacyPath);
+        legacySec = timed(legacy);
+        summarize(legacyMean, legacyP99, legacyMax);
+    }
+    uint64_t stalls;
+    {
+        CsvLogger csv;
+        csv.setColumns(names);
+        csv.open(asyncPath);
+        asyncSec = timed(csv);
+        summarize(asyncMean, asyncP99, asyncMax);
+        csv.close();
+        stalls = csv.producerStalls();
+    }
+    bool same = readFile(legacyPath) == readFile(asyncPath);
+    std::filesystem::remove(legacyPath);
+    std::filesystem::remove(asyncPath);
+    if (!same) { std::cerr << "csv output differs from the ostream logger\n"; std::exit(1); }
+    std::cout << "csv fields=" << fieldCount << " rows=" << rows
+              << " legacy_rows_per_sec=" << static_cast<double>(rows) / legacySec
+              << " async_rows_per_sec=" << static_cast<double>(rows) / asyncSec
+              << " legacy_call_ns_mean=" << legacyMean << " p99=" << legacyP99 << " max=" << legacyMax
+              << " async_call_ns_mean=" << asyncMean << " p99=" << asyncP99 << " max=" << asyncMax
+              << " producer_stalls=" << stalls << "\n";
+}
+
+// Keeps the measured loops' results observable
+volatile size_t g_sink = 0;
+
+// One row of the suite: a pipeline stage at one config size.
+struct StageResult {
+    std::string stage;
+    size_t fields;
+    size_t keys;
+    const char* unit;     // what one op is: msg or tick
+    uint64_t ops;
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+// Runs fn() once (it performs `ops` operations) and records time and heap allocations.
+template <typename Fn>
+void measure(std::vector<StageResult>& out, const char* stage, const char* unit, size_t fields, size_t keys,
+             uint64_t ops, Fn&& fn) {
+    uint64_t allocs = g_allocCount.load();
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    auto t1 = std::chrono::steady_clock::now();
+    allocs = g_allocCount.load() - allocs;
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    StageResult r{stage, fields, keys, unit, ops, ns / static_cast<double>(ops),
+                  static_cast<double>(allocs) / static_cast<double>(ops)};
+    std::cout << "suite stage=" << r.stage << " fields=" << r.fields << " keys=" << r.keys
+              << " unit=" << r.unit << " ops=" << r.ops << " ns_per_op=" << r.nsPerOp
+              << " ops_per_sec=" << (1e9 / r.nsPerOp) << " allocs_per_op=" << r.allocsPerOp << "\n";
+    out.push_back(std::move(r));
+}
+
+#ifdef DDC_DECODER_CONFIG
+// Generated decoders vs the DecodeOp table vs process() (table plus name lookup), on the
+// config the decoders were built from
+void benchGenerated(size_t iterations, std::vector<StageResult>& out) {
+    std::string err;
+    auto cfg = ConfigLoader::loadFromFile(DDC_DECODER_CONFIG, err);
+    if (!cfg) return;
+    AppConfig tableCfg = *cfg;
+    tableCfg.generatedDecoders = false;
+    ExtractionEngine generated(*cfg), table(tableCfg);
+    auto raws = makeKeyTraffic(*cfg, 4096, false);
+    auto msgs = parseAll(raws);
+    const uint64_t ops = static_cast<uint64_t>(msgs.size()) * iterations;
+    const size_t fields = table.fieldCount(), keys = table.plan().groupCount();
+    std::vector<FieldValue> buf(table.maxValuesPerMessage());
+    size_t sink = 0;
+    auto loop = [&](ExtractionEngine& engine) {
+        return [&] {
+            for (size_t it = 0; it < iterations; ++it)
+                for (const auto& m : msgs) sink += engine.extract(m, buf.data(), buf.size());
+        };
+    };
+    auto processLoop = [&] {
+        for (size_t it = 0; it < iterations; ++it)
+            for (const auto& m : msgs) sink += table.process(m).size();
+    };
+    loop(generated)(); loop(table)(); processLoop();
+    measure(out, "extract_generated", "msg", fields, keys, ops, loop(generated));
+    measure(out, "extract_table", "msg", fields, keys, ops, loop(table));
+    measure(out, "process_table", "msg", fields, keys, ops, processLoop);
+    g_sink = g_sink + sink;
+}
+
+#endif
+
+// Each hot-path stage on its own, plus the full parse -> extract -> encode path, with the
+// same synthetic traffic. Every stage is warmed up once before it is measured.
+void benchSuite(size_t fieldCount, size_t keyCount, size_t iterations, std::vector<StageResult>& out) {
+    AppConfig cfg = makeConfig(fieldCount, keyCount);
+    auto raws = makeMessages(cfg, 4096);
+    auto msgs = parseAll(raws);
+    const uint64_t ops = static_cast<uint64_t>(raws.size()) * iterations;
+    // Snapshots cost O(fields); keep the tick count proportionate
+    const size_t ticks = std::max<size_t>(10, iterations * 1000 / fieldCount);
+    MessageParser parser;
+    ExtractionEngine engine(cfg);
+    std::vector<FieldValue> buf(engine.maxValuesPerMessage());
+    std::vector<std::string> names;
+    for (uint32_t id = 0; id < engine.fieldCount(); ++id) names.push_back(engine.fieldName(id));
+    SnapshotSerializer serializer(names);
+    ImmediateEncoder immediate(names);
+    ValueSnapshot snap;
+    std::string payload;
+    ParsedMessage p;
+    size_t sink = 0;
+
+    auto parseLoop = [&] {
+        for (size_t it = 0; it < iterations; ++it)
+            for (const auto& r : raws) sink += parser.parse(r, p);
+    };
+    auto processLoop = [&] {
+        for (size_t it = 0; it < iterations; ++it)
+            for (const auto& m : msgs) sink += engine.process(m).size();
+    };
+    auto extractLoop = [&] {
+        for (size_t it = 0; it < iterations; ++it)
+            for (const auto& m : msgs) sink += engine.extract(m, buf.data(), buf.size());
+    };
+    auto immediateLoop = [&] {
+        for (size_t it = 0; it < iterations; ++it) {
+            for (const auto& r : raws) {
+                if (!parser.parse(r, p)) continue;
+                size_t n = engine.extract(p, buf.data(), buf.size());
+                for (size_t i = 0; i < n; ++i) { immediate.encode(buf[i], sink, payload); sink += payload.size(); }
+            }
+        }
+    };
+    auto domLoop = [&] {
+        for (size_t t = 0; t < ticks; ++t) {
+            auto j = engine.buildJsonSnapshot();
+            j["seq"] = t;
+            sink += j.dump().size();
+        }
+    };
+    auto snapshotLoop = [&] {
+        for (size_t t = 0; t < ticks; ++t) {
+            engine.snapshot(snap);
+            serializer.serialize(snap, t, payload);
+            sink += payload.size();
+        }
+    };
+    // Same traffic with every field aggregated for one batch output
+    AppConfig aggCfg = cfg;
+    aggCfg.batchMessages = true;
+    for (auto& f : aggCfg.streams.front().fields) f.aggregate = Aggregate::Mean;
+    ExtractionEngine aggEngine(aggCfg);
+    auto aggregateLoop = [&] {
+        for (size_t it = 0; it < iterations; ++it)
+            for (const auto& m : msgs) sink += aggEngine.extract(m, buf.data(), buf.size());
+    };
+    // Parse + extract as the processing thread runs them, with and without latency recording
+    LatencyStats latency;
+    LatencyStats::Shard* shard = latency.addShard("bench");
+    auto untimedLoop = [&] {
+        for (size_t it = 0; it < iterations; ++it)
+            for (const auto& r : raws)
+                if (parser.parse(r, p)) sink += engine.extract(p, buf.data(), buf.size());
+    };
+    auto timedLoop = [&] {
+        for (size_t it = 0; it < iterations; ++it) {
+            for (const auto& r : raws) {
+                uint64_t t = shard->since(LatencyStage::Queue, r.timestamp + 1);
+                const bool timed = shard->sample();
+                if (!parser.parse(r, p)) continue;
+                if (timed) t = shard->since(LatencyStage::Parse, t);
+                sink += engine.extract(p, buf.data(), buf.size());
+                if (timed) shard->since(LatencyStage::Extract, t);
+            }
+        }
+    };
+    Metrics metrics;
+    Metrics::Shard* counts = metrics.addShard();
+    auto countedLoop = [&] {
+        for (size_t it = 0; it < iterations; ++it) {
+            for (const auto& r : raws) {
+                counts->add(Counter::Processed);
+                if (!parser.parse(r, p)) { counts->add(Counter::ParseErrors); continue; }
+                size_t n = engine.extract(p, buf.data(), buf.size());
+                size_t key = msgKeyIndex(r.rtAddress, r.subAddress, r.tx);
+                counts->message(key, engine.plan().slot(key).count, n);
+                sink += n;
+            }
+        }
+    };
+    BusAnalyzer analyzer;
+    const uint64_t span = raws.back().timestamp + 20;
+    uint64_t pass = 0;
+    auto analyzeLoop = [&] {
+        for (size_t it = 0; it < iterations; ++it, ++pass)
+            for (const auto& r : raws) analyzer.observe(msgKeyIndex(r.rtAddress, r.subAddress, r.tx), r.timestamp + pass * span);
+    };
+    parseLoop(); processLoop(); extractLoop(); aggregateLoop(); immediateLoop(); domLoop(); snapshotLoop();
+    untimedLoop(); timedLoop(); countedLoop(); analyzeLoop();
+
+    measure(out, "parse", "msg", fieldCount, keyCount, ops, parseLoop);
+    measure(out, "process", "msg", fieldCount, keyCount, ops, processLoop);
+    measure(out, "extract", "msg", fieldCount, keyCount, ops, extractLoop);
+    measure(out, "extract_aggregate", "msg", fieldCount, keyCount, ops, aggregateLoop);
+    measure(out, "parse_extract_immediate", "msg", fieldCount, keyCount, ops, immediateLoop);
+    measure(out, "parse_extract", "msg", fieldCount, keyCount, ops, untimedLoop);
+    measure(out, "parse_extract_latency", "msg", fieldCount, keyCount, ops, timedLoop);
+    measure(out, "parse_extract_metrics", "msg", fieldCount, keyCount, ops, countedLoop);
+    measure(out, "bus_analyze", "msg", fieldCount, keyCount, ops, analyzeLoop);
+    measure(out, "snapshot_dom_dump", "tick", fieldCount, keyCount, ticks, domLoop);
+    measure(out, "snapshot_serialize", "tick", fieldCount, keyCount, ticks, snapshotLoop);
+
+    // CSV: the producer side (writeValues), including the final flush so a writer that
+    // cannot keep up shows in the rate
+    std::vector<std::vector<FieldValue>> batches;
+    for (const auto& m : msgs) {
+        size_t n = engine.extract(m, buf.data(), buf.size());
+        if (n) batches.emplace_back(buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(n));
+    }
+    std::string csvPath = (std::filesystem::temp_directory_path() / "ddc_bench_suite.csv").string();
+    {
+        CsvLogger csv;
+        csv.setColumns(names);
+        csv.open(csvPath);
+        for (const auto& b : batches) csv.writeValues(b.data(), b.size());
+        csv.flush();
+        // Every row carries every column, so scale the row count down with the width too
+        const size_t rows = std::max<size_t>(256, static_cast<size_t>(ops * 10 / fieldCount));
+        measure(out, "csv_write_values", "msg", fieldCount, keyCount, rows, [&] {
+            for (size_t r = 0; r < rows; ++r) csv.writeValues(batches[r % batches.size()].data(), batches[r % batches.size()].size());
+            csv.flush();
+        });
+    }
+    std::filesystem::remove(csvPath);
+    g_sink = g_sink + sink;
+}
+
+// Parse + extract through the worker pool at 1..8 workers: dispatch to drained, so queueing
+// and the gather thread are included. Speedup is against one worker.
+void benchPool(size_t fieldCount, size_t keyCount, size_t iterations, std::vector<StageResult>& out) {
+    AppConfig cfg = makeConfig(fieldCount, keyCount);
+    auto raws = makeMessages(cfg, 4096);
+    const uint64_t ops = static_cast<uint64_t>(raws.size()) * iterations;
+    for (bool forward : {false, true}) {
+        double base = 0.0;
+        for (size_t workers : {1, 2, 4, 8}) {
+            ExtractionEngine engine(cfg);
+            ExtractionPool pool(engine, workers, 8192, forward);
+            size_t values = 0;
+            pool.start([&](const FieldValue*, size_t count, uint64_t) { values += count; });
+            std::string stage = std::string(forward ? "pool_forward_w" : "pool_w") + std::to_string(workers);
+            measure(out, stage.c_str(), "msg", fieldCount, keyCount, ops, [&] {
+                for (size_t it = 0; it < iterations; ++it)
+                    for (const auto& r : raws) pool.dispatch(r);
+                pool.stop();
+            });
+            if (workers == 1) base = out.back().nsPerOp;
+            std::cout << "pool fields=" << fieldCount << " workers=" << workers << " forward=" << forward
+                      << " speedup=" << (base / out.back().nsPerOp) << " values=" << values << "\n";
+        }
+    }
+}
+
+bool writeSuiteJson(const std::string& path, size_t iterations, const std::vector<StageResult>& results) {
+    nlohmann::json j;
+    j["format"] = "ddc_bench";
+    j["version"] = 1;
+    j["iterations"] = iterations;
+    j["timestamp_unix"] = static_cast<int64_t>(std::time(nullptr));
+    nlohmann::json rows = nlohmann::json::array();
+    for (const auto& r : results) {
+        rows.push_back({{"stage", r.stage}, {"fields", r.fields}, {"keys", r.keys}, {"unit", r.unit},
+                        {"ops", r.ops}, {"ns_per_op", r.nsPerOp}, {"ops_per_sec", 1e9 / r.nsPerOp},
+                        {"allocs_per_op", r.allocsPerOp}});
+    }
+    j["results"] = std::move(rows);
+    std::ofstream ofs(path);
+    ofs << j.dump(2) << "\n";
+    return static_cast<bool>(ofs);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t iterations = 50;
+    std::string jsonPath;
+    bool suiteOnly = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--json" && i + 1 < argc) jsonPath = argv[++i];
+        else if (a == "--suite-only") suiteOnly = true;
+        else iterations = std::stoul(a);
+    }
+    std::vector<StageResult> results;
+    benchSuite(10, 2, iterations, results);
+    benchSuite(100, 20, iterations, results);
+    benchSuite(1000, 100, iterations, results);
+    benchSuite(10000, 500, std::max<size_t>(1, iterations / 5), results);
+    benchPool(10000, 500, std::max<size_t>(1, iterations / 5), results);
+#ifdef DDC_DECODER_CONFIG
+    benchGenerated(iterations * 10, results);
+#endif
+    if (!jsonPath.empty() && !writeSuiteJson(jsonPath, iterations, results)) {
+        std::cerr << "cannot write " << jsonPath << "\n";
+        return 1;
+    }
+    if (suiteOnly) return 0;
+    benchExtraction(10, 2, iterations);
+    benchExtraction(100, 20, iterations);
+    benchExtraction(1000, 100, iterations);
+    benchSnapshot(10, 2, iterations * 20);
+    benchSnapshot(100, 20, iterations * 5);
+    benchSnapshot(1000, 100, iterations);
+    benchImmediate(10, 2, iterations);
+    benchImmediate(100, 20, iterations);
+    benchBinary(100, 20, iterations * 5);
+    benchBinary(1000, 100, iterations);
+    benchCsv(100, 20, iterations * 400);
+    benchCsv(1000, 100, iterations * 40);
+    return 0;
+}
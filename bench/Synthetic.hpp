@@ -0,0 +1,100 @@
+#pragma once
+#include "Config.hpp"
+#include "MessageParser.hpp"
+#include "B1553Monitor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Synthetic configs and traffic shared by ddc_bench and ddc_tests.
+namespace ddc {
+
+// Synthetic config: `fieldCount` fields spread over RT 1-30 / SA 1-30 receive keys,
+// cycling through the supported field types.
+inline AppConfig makeConfig(size_t fieldCount, size_t keyCount) {
+    AppConfig cfg;
+    StreamConfig sc; sc.name = "bench";
+    for (size_t i = 0; i < fieldCount; ++i) {
+        size_t key = i % keyCount;
+        FieldSpec f;
+        f.name = "group" + std::to_string(key) + ".field" + std::to_string(i);
+        f.rt = static_cast<uint16_t>(1 + key % 30);
+        f.subAddress = static_cast<uint16_t>(1 + (key / 30) % 30);
+        f.transmit = false;
+        int w = 1 + static_cast<int>((i / keyCount) % 30);
+        switch (i % 5) {
+        case 0: f.startWord = f.endWord = w; f.singleBit = true; f.bit = static_cast<int>(i % 16); f.type = "raw"; break;
+        case 1: f.startWord = f.endWord = w; f.lsbScale = std::pow(2.0, -5); f.type = "float"; break;
+        case 2: f.startWord = w; f.endWord = w + 1; f.lsbScale = std::pow(2.0, -7); f.type = "float"; break;
+        case 3: f.startWord = w; f.endWord = w + 1; f.type = "signed"; break;
+        default: f.startWord = w; f.endWord = w + 1; f.type = "ieee754"; break;
+        }
+        sc.fields.push_back(f);
+    }
+    cfg.streams.push_back(std::move(sc));
+    return cfg;
+}
+
+inline std::vector<Raw1553Message> makeMessages(const AppConfig& cfg, size_t count) {
+    std::mt19937 rng{1234};
+    std::uniform_int_distribution<int> word(0, 0xFFFF);
+    std::vector<MsgKey> keys;
+    for (auto& f : cfg.streams.front().fields) {
+        MsgKey k{f.rt, f.subAddress, f.transmit};
+        bool known = false;
+        for (auto& e : keys) if (e == k) { known = true; break; }
+        if (!known) keys.push_back(k);
+    }
+    std::vector<Raw1553Message> msgs(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto& m = msgs[i];
+        // Every 4th message is bus traffic the config does not extract from
+        MsgKey k = (i % 4 == 3) ? MsgKey{31, static_cast<uint16_t>(i % 32), true} : keys[i % keys.size()];
+        m.rtAddress = k.rt; m.subAddress = k.sa; m.tx = k.tx; m.wordCount = 32;
+        m.timestamp = i * 20;
+        m.dataWordCount = 32;
+        for (auto& w : m.dataWords) w = static_cast<uint16_t>(word(rng));
+    }
+    return msgs;
+}
+
+// Parsed views into `raws`, which must outlive the result
+inline std::vector<ParsedMessage> parseAll(const std::vector<Raw1553Message>& raws) {
+    MessageParser parser;
+    std::vector<ParsedMessage> out(raws.size());
+    for (size_t i = 0; i < raws.size(); ++i) parser.parse(raws[i], out[i]);
+    return out;
+}
+
+inline std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Traffic on every key of `cfg`; with `shortMessages`, word counts cycle 1..32 so every
+// field is also seen out of bounds.
+inline std::vector<Raw1553Message> makeKeyTraffic(const AppConfig& cfg, size_t count, bool shortMessages) {
+    std::mt19937 rng{77};
+    std::uniform_int_distribution<int> word(0, 0xFFFF);
+    std::vector<MsgKey> keys;
+    for (const auto& sc : cfg.streams)
+        for (const auto& f : sc.fields) {
+            MsgKey k{f.rt, f.subAddress, f.transmit};
+            if (std::find(keys.begin(), keys.end(), k) == keys.end()) keys.push_back(k);
+        }
+    std::vector<Raw1553Message> msgs(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto& m = msgs[i];
+        MsgKey k = keys.empty() ? MsgKey{31, 1, true} : keys[i % keys.size()];
+        m.rtAddress = k.rt; m.subAddress = k.sa; m.tx = k.tx;
+        m.wordCount = m.dataWordCount = static_cast<uint16_t>(shortMessages ? 1 + (i / keys.size()) % 32 : 32);
+        m.timestamp = i * 20;
+        for (auto& w : m.dataWords) w = static_cast<uint16_t>(word(rng));
+    }
+    return msgs;
+}
+
+} // namespace ddc
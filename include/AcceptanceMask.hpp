@@ -0,0 +1,55 @@
+#pragma once
+#include "ExtractionPlan.hpp"
+#include <array>
+#include <cstdint>
+
+namespace ddc {
+
+// One bit per (RT,SA,T/R) key, indexed by msgKeyIndex(): the traffic worth building a message
+// for. Word `rt` holds that RT's 32 subaddresses x 2 directions, so per-RT subaddress masks
+// (the shape of a hardware monitor filter) come straight out of it.
+class AcceptanceMask {
+public:
+    static constexpr size_t kWords = kMsgKeySpace / 64;
+
+    AcceptanceMask() { m_bits.fill(~0ull); }   // accepts everything
+
+    // Keys the plan decodes at least one field from
+    static AcceptanceMask fromPlan(const ExtractionPlan& plan) {
+        AcceptanceMask m;
+        m.m_bits.fill(0);
+        for (size_t k = 0; k < kMsgKeySpace; ++k)
+            if (plan.slot(k).count) m.m_bits[k >> 6] |= 1ull << (k & 63);
+        return m;
+    }
+
+    static AcceptanceMask fromWords(const std::array<uint64_t, kWords>& words) {
+        AcceptanceMask m;
+        m.m_bits = words;
+        return m;
+    }
+
+    bool acceptsKey(size_t key) const { return (m_bits[key >> 6] >> (key & 63)) & 1; }
+    bool all() const {
+        for (uint64_t w : m_bits) if (w != ~0ull) return false;
+        return true;
+    }
+    size_t keyCount() const {
+        size_t n = 0;
+        for (uint64_t w : m_bits) for (; w; w &= w - 1) ++n;
+        return n;
+    }
+    // Subaddresses of `rt` accepted in direction `tx`, bit = SA
+    uint32_t subaddressMask(uint16_t rt, bool tx) const {
+        uint32_t mask = 0;
+        for (uint16_t sa = 0; sa < 32; ++sa)
+            if (acceptsKey(msgKeyIndex(rt, sa, tx))) mask |= 1u << sa;
+        return mask;
+    }
+    const std::array<uint64_t, kWords>& words() const { return m_bits; }
+
+private:
+    std::array<uint64_t, kWords> m_bits;
+};
+
+} // namespace ddc
@@ -0,0 +1,17 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+namespace ddc {
+
+// Destructive interference size: data written by different threads is kept this far apart
+constexpr size_t kCacheLine = 64;
+
+// Adds to an atomic that only one thread writes: a relaxed load and store, no locked
+// read-modify-write. Readers on other threads always see a whole value.
+template <typename T>
+inline void singleWriterAdd(std::atomic<T>& a, typename std::atomic<T>::value_type n) {
+    a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+} // namespace ddc
@@ -1,6 +1,10 @@
 #pragma once
+#include "Atomics.hpp"
+#include <array>
+#include <chrono>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 #include <atomic>
 #include <thread>
@@ -11,6 +15,14 @@ struct ACE_MESSAGE_STRUCT; // Placeholder for an actual SDK message structure
 
 namespace ddc {
 
+class RawRecordingReader;
+class BusSimulator;
+class AcceptanceMask;
+struct AppConfig;
+
+// A 1553 message never carries more than 32 data words.
+constexpr size_t kMax1553DataWords = 32;
+
 struct Raw1553Message {
     uint16_t rtAddress{};   // RT (0-31)
     bool tx{};              // true if RT->BC transmission (Transmit direction flag)
@@ -18,8 +30,11 @@ struct Raw1553Message {
     uint16_t wordCount{};   // Word count or mode code
     bool isModeCode{};      // Word count field interpreted as mode code
     uint16_t channel{};     // Channel number (A/B)
+    uint16_t bus{};         // Capturing device (index into AppConfig::devices)
     uint64_t timestamp{};   // Hardware timestamp (e.g., nanoseconds or microseconds)
-    std::vector<uint16_t> dataWords; // Payload data words
+    uint64_t hostTimeNs{};  // Host steady clock at capture (steadyNowNs), for latency stats; not recorded
+    std::array<uint16_t, kMax1553DataWords> dataWords{}; // Payload data words (inline, no allocation)
+    uint16_t dataWordCount{}; // Number of valid entries in dataWords
     uint32_t statusWord1{}; // Primary status word
     uint32_t statusWord2{}; // Secondary status (if applicable)
 };
@@ -35,11 +50,35 @@ public:
     // deviceName: e.g., "ACE0" or board identifier from DDC API enumeration.
     bool open(const std::string& deviceName, uint32_t channelMask = 0x3); // Channel A/B both by default
 
-    // Enable internal simulation instead of hardware (must be called before start)
-    void enableSimulation(double rateHz, const std::vector<uint16_t>& rts,
-                          const std::vector<uint16_t>& subAddresses,
-                          uint16_t wordCount = 32,
-                          bool randomPattern = true);
+    // Enable internal simulation instead of hardware (must be called before start): traffic
+    // follows cfg.simSchedule (or one entry per field key), sent a minor frame at a time.
+    void enableSimulation(const AppConfig& cfg);
+
+    // Feed messages from a raw recording (see RawRecording.hpp) instead of hardware, keeping
+    // the recorded timestamps. speed: 1 = real time, N = N times faster, 0 = as fast as possible.
+    // Must be called before start; takes precedence over simulation.
+    bool enableReplay(const std::string& path, double speed, std::string& err);
+
+    // Replay reached the end of the recording (always false otherwise).
+    bool finished() const { return m_finished.load(); }
+
+    // Tag for every message from this monitor (Raw1553Message::bus); replay keeps recorded tags.
+    void setBus(uint16_t bus) { m_bus = bus; }
+    // Common zero for timestamps when several monitors are merged (default: this monitor's
+    // start). Must be called before start.
+    void setTimeBase(std::chrono::steady_clock::time_point origin) { m_timeBase = origin; }
+
+    // Simulation only (read after stop): the generator, and minor frames that started more
+    // than one frame period late.
+    const BusSimulator* simulator() const { return m_sim.get(); }
+    uint64_t simLateFrames() const { return m_simLateFrames; }
+
+    // Pre-parse filter: messages of keys outside `mask` are dropped with a single bit test
+    // before they are built (hardware, simulation) or their data words decoded (replay).
+    // May be called while running (config reload); takes effect within a few messages.
+    void setAcceptance(const AcceptanceMask& mask);
+    uint64_t accepted() const { return m_accepted.load(std::memory_order_relaxed); }
+    uint64_t filtered() const { return m_filtered.load(std::memory_order_relaxed); }
 
     // Start asynchronous monitoring loop.
     bool start(MessageCallback cb);
@@ -49,19 +88,40 @@ public:
 
 private:
     void monitorLoop();
+    void replayLoop();
+    void simulationLoop();
+    bool waitUntil(std::chrono::steady_clock::time_point due) const;
+    // Counts the message; false if it is filtered out
+    bool accept(uint16_t rt, uint16_t sa, bool tx) {
+        const size_t key = (static_cast<size_t>(rt & 0x1F) << 6) | (static_cast<size_t>(sa & 0x1F) << 1) | (tx ? 1u : 0u);
+        const bool ok = (m_accept[key >> 6].load(std::memory_order_relaxed) >> (key & 63)) & 1;
+        count(ok ? 1 : 0, ok ? 0 : 1);
+        return ok;
+    }
+    void count(uint64_t accepted, uint64_t filtered) {
+        singleWriterAdd(m_accepted, accepted);
+        singleWriterAdd(m_filtered, filtered);
+    }
+    AcceptanceMask acceptance() const;     // current filter, one consistent copy
 
     std::atomic<bool> m_running{false};
     std::thread m_thread;
     MessageCallback m_callback;
     void* m_deviceHandle{nullptr}; // Replace with real handle type (e.g., ACE_HANDLE)
     uint32_t m_channelMask{0};
-    // Simulation parameters
-    bool m_simulation{false};
-    double m_simIntervalSec{0.02};
-    std::vector<uint16_t> m_simRTs;
-    std::vector<uint16_t> m_simSAs;
-    uint16_t m_simWC{16};
-    bool m_simPatternRandom{true};
+    uint16_t m_bus{0};
+    std::chrono::steady_clock::time_point m_timeBase{};
+    // Acceptance bitmap (see AcceptanceMask), word per RT; counts written by the monitor thread only
+    std::array<std::atomic<uint64_t>, 32> m_accept;
+    std::atomic<uint64_t> m_accepted{0};
+    std::atomic<uint64_t> m_filtered{0};
+    // Simulation
+    std::unique_ptr<BusSimulator> m_sim;
+    uint64_t m_simLateFrames{0};
+    // Replay parameters
+    std::unique_ptr<RawRecordingReader> m_replay;
+    double m_replaySpeed{1.0};
+    std::atomic<bool> m_finished{false};
 };
 
 } // namespace ddc
@@ -0,0 +1,53 @@
+#pragma once
+#include "BinaryFormat.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ddc {
+
+struct DecodedValue {
+    uint32_t fieldId{};
+    double value{};
+};
+
+struct DecodedFrame {
+    uint32_t schemaId{};
+    uint64_t seq{};
+    uint64_t timestampUs{};
+    std::vector<DecodedValue> values; // field-id order
+};
+
+// Reference consumer for the binary output format. Depends only on BinaryFormat.hpp,
+// so it can be copied into client tools as is.
+class BinaryDecoder {
+public:
+    enum class Result {
+        Data,       // `out` holds a decoded data datagram
+        Schema,     // schema fragment consumed (schemaComplete() tells when all arrived)
+        NeedSchema, // data datagram for a schema that has not been fully received yet
+        Invalid,    // malformed or foreign datagram
+    };
+
+    Result feed(const uint8_t* data, size_t size, DecodedFrame& out);
+
+    bool schemaComplete() const { return m_complete; }
+    uint32_t schemaId() const { return m_schemaId; }
+    size_t fieldCount() const { return m_names.size(); }
+    const std::string& fieldName(uint32_t id) const { return m_names[id]; }
+    WireType wireType(uint32_t id) const { return m_types[id]; }
+
+private:
+    Result feedSchema(const uint8_t* p, size_t size, uint32_t schemaId);
+    Result feedData(const uint8_t* p, size_t size, uint32_t schemaId, DecodedFrame& out) const;
+
+    uint32_t m_schemaId{0};
+    bool m_complete{false};
+    std::vector<std::string> m_names;
+    std::vector<WireType> m_types;
+    std::vector<uint8_t> m_fragmentSeen;
+    size_t m_fragmentsMissing{0};
+};
+
+} // namespace ddc
@@ -0,0 +1,45 @@
+#pragma once
+#include "BinaryFormat.hpp"
+#include "Config.hpp"
+#include "ExtractionPlan.hpp"
+#include "LatestValueStore.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ddc {
+
+// Wire type used when a field has no wire_type override: the narrowest type that
+// represents every decodable value exactly (bits -> u8, unscaled ints -> i32/u32,
+// power-of-two scaled values of <= 24 significant bits -> f32, otherwise f64).
+WireType defaultWireType(const FieldSpec& f);
+
+// Encoder for the binary output format (see BinaryFormat.hpp).
+class BinaryEncoder {
+public:
+    // fields: every field indexed by field id.
+    // fieldIds: fields encodeSnapshot() may include (empty = all). The schema always lists every field.
+    explicit BinaryEncoder(const std::vector<FieldSpec>& fields, const std::vector<uint32_t>& fieldIds = {});
+
+    // Hash of field names and wire types; changes whenever the schema does.
+    uint32_t schemaId() const { return m_schemaId; }
+    WireType wireType(uint32_t fieldId) const { return m_types[fieldId]; }
+
+    // Batch mode: every included field that is valid in `snap`; timestamp is the latest of those.
+    void encodeSnapshot(const ValueSnapshot& snap, uint64_t seq, std::string& out) const;
+    // Immediate mode: a single value.
+    void encodeValue(const FieldValue& v, uint64_t seq, std::string& out) const;
+
+    // Schema announcement, split into MTU-sized fragments; `announcement` goes into seq.
+    void encodeSchema(uint64_t announcement, std::vector<std::string>& fragments) const;
+
+private:
+    uint8_t* writeValue(uint8_t* p, uint32_t fieldId, double value) const;
+
+    std::vector<std::string> m_names;
+    std::vector<WireType> m_types;
+    std::vector<uint8_t> m_included;  // per field id; empty = all
+    uint32_t m_schemaId{0};
+};
+
+} // namespace ddc
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace ddc {
+
+// Binary output format (output_format = "binary"). All integers little-endian.
+//
+// Common header (28 bytes):
+//   u32 magic "DDCB" | u8 version | u8 kind | u16 reserved | u32 schemaId | u64 seq | u64 timestamp_us
+// Data datagram (kind 0), after the header:
+//   u32 firstField | u16 bitmapBytes | u16 reserved | bitmap | packed values
+//   Bit i of the bitmap (LSB first) marks field firstField+i as present; present values
+//   follow in field-id order, each in its field's wire type.
+// Schema datagram (kind 1), after the header (seq counts announcements, timestamp_us is 0):
+//   u16 fragment | u16 fragmentCount | u32 fieldCount | u32 firstField | u16 entryCount | u16 reserved
+//   entryCount x { u8 wireType | u16 nameLength | name bytes (dotted config name) }
+constexpr uint32_t kBinaryMagic = 0x42434444u; // "DDCB"
+constexpr uint8_t kBinaryVersion = 1;
+constexpr size_t kBinaryHeaderSize = 28;
+constexpr size_t kBinaryDataHeaderSize = kBinaryHeaderSize + 8;
+constexpr size_t kBinarySchemaHeaderSize = kBinaryHeaderSize + 16;
+constexpr size_t kBinarySchemaMaxDatagram = 1400; // keep schema fragments under a typical MTU
+
+enum class BinaryKind : uint8_t { Data = 0, Schema = 1 };
+
+enum class WireType : uint8_t { U8 = 0, I32 = 1, U32 = 2, F32 = 3, F64 = 4 };
+
+inline size_t wireTypeSize(WireType t) {
+    switch (t) {
+    case WireType::U8: return 1;
+    case WireType::I32:
+    case WireType::U32:
+    case WireType::F32: return 4;
+    case WireType::F64: return 8;
+    }
+    return 0;
+}
+
+inline bool wireTypeFromByte(uint8_t b, WireType& t) {
+    if (b > static_cast<uint8_t>(WireType::F64)) return false;
+    t = static_cast<WireType>(b);
+    return true;
+}
+
+// Config spelling: u8, i32, u32, f32, f64
+inline bool parseWireType(const std::string& s, WireType& t) {
+    if (s == "u8") t = WireType::U8;
+    else if (s == "i32") t = WireType::I32;
+    else if (s == "u32") t = WireType::U32;
+    else if (s == "f32") t = WireType::F32;
+    else if (s == "f64") t = WireType::F64;
+    else return false;
+    return true;
+}
+
+inline void putLE(uint8_t* p, uint64_t v, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+inline uint64_t getLE(const uint8_t* p, size_t bytes) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < bytes; ++i) v |= static_cast<uint64_t>(p[i]) << (8 * i);
+    return v;
+}
+
+inline void writeBinaryHeader(uint8_t* p, BinaryKind kind, uint32_t schemaId, uint64_t seq, uint64_t timestampUs) {
+    putLE(p, kBinaryMagic, 4);
+    p[4] = kBinaryVersion;
+    p[5] = static_cast<uint8_t>(kind);
+    putLE(p + 6, 0, 2);
+    putLE(p + 8, schemaId, 4);
+    putLE(p + 12, seq, 8);
+    putLE(p + 20, timestampUs, 8);
+}
+
+} // namespace ddc
@@ -0,0 +1,85 @@
+#pragma once
+#include "Atomics.hpp"
+#include "Config.hpp"
+#include "ExtractionPlan.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ddc {
+
+// Online bus schedule check: inter-arrival statistics per (RT,SA,T/R) key from the message
+// timestamps (bus time, us). O(1) and no allocation per message, fixed memory for all 2048
+// keys. Jitter is a gap's deviation from the key's expected period, or from the previous
+// gap when no rate is expected; with an expected rate, a gap of n periods counts n - 1
+// missed slots. Counts since start; rates over any interval come from two snapshots.
+class BusAnalyzer {
+public:
+    // |deviation| < 1 us, then [2^(i-1), 2^i) us; the last bin is open-ended (>= 16 ms)
+    static constexpr size_t kJitterBins = 16;
+
+    struct KeyStats {
+        uint64_t messages{0};
+        uint64_t gaps{0};               // inter-arrival samples (messages - 1 - out of order)
+        uint64_t gapSumUs{0};
+        uint64_t minGapUs{0};
+        uint64_t maxGapUs{0};
+        uint64_t missed{0};             // slots without a message (expected rate only)
+        uint64_t outOfOrder{0};         // timestamps before the previous one (not sampled)
+        uint64_t lastUs{0};
+        double expectedHz{0.0};
+        double jitterRmsUs{0.0};
+        std::array<uint64_t, kJitterBins> jitter{};
+
+        double meanGapUs() const { return gaps ? static_cast<double>(gapSumUs) / static_cast<double>(gaps) : 0.0; }
+        double rateHz() const { return gapSumUs ? 1e6 * static_cast<double>(gaps) / static_cast<double>(gapSumUs) : 0.0; }
+    };
+
+    explicit BusAnalyzer(const std::vector<ExpectedRate>& expected = {});
+
+    // Single writer (the processing thread), messages in bus-time order
+    void observe(size_t key, uint64_t timestampUs) {
+        Key& k = m_keys[key];
+        const uint64_t n = k.messages.load(std::memory_order_relaxed);
+        const uint64_t last = k.lastUs.load(std::memory_order_relaxed);
+        singleWriterAdd(k.messages, 1);
+        if (n == 0) { k.lastUs.store(timestampUs, std::memory_order_relaxed); return; }
+        if (timestampUs < last) { singleWriterAdd(k.outOfOrder, 1); return; }
+        k.lastUs.store(timestampUs, std::memory_order_relaxed);
+        sample(k, m_periodUs[key], timestampUs - last);
+    }
+
+    // Reader side (any thread): by key index, resized to kMsgKeySpace. Each counter is exact,
+    // but a key's counters may be from consecutive messages.
+    void snapshot(std::vector<KeyStats>& out) const;
+    // Keys with traffic or an expected rate, one line each
+    std::string report() const;
+
+    static size_t jitterBin(uint64_t deviationUs);
+
+private:
+    struct alignas(kCacheLine) Key {
+        std::atomic<uint64_t> messages{0};
+        std::atomic<uint64_t> lastUs{0};
+        std::atomic<uint64_t> prevGapUs{0};
+        std::atomic<uint64_t> gaps{0};
+        std::atomic<uint64_t> gapSumUs{0};
+        std::atomic<uint64_t> minGapUs{~0ull};
+        std::atomic<uint64_t> maxGapUs{0};
+        std::atomic<uint64_t> missed{0};
+        std::atomic<uint64_t> outOfOrder{0};
+        std::atomic<uint64_t> jitterSamples{0};
+        std::atomic<double> jitterSumSq{0.0};
+        std::array<std::atomic<uint64_t>, kJitterBins> jitter{};
+    };
+
+    void sample(Key& k, double periodUs, uint64_t gapUs);
+
+    std::unique_ptr<Key[]> m_keys;
+    std::vector<double> m_periodUs;   // expected period per key (0 = none)
+};
+
+} // namespace ddc
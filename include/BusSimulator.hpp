@@ -0,0 +1,81 @@
+#pragma once
+#include "AcceptanceMask.hpp"
+#include "B1553Monitor.hpp"
+#include "Config.hpp"
+#include "ExtractionPlan.hpp"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace ddc {
+
+// Generates bus traffic from a minor-frame schedule. Every minor frame each entry gains
+// rate / minorFrameHz credits and is sent once per whole credit, so an entry at a fraction
+// of the frame rate lands in every k-th frame and a faster one repeats within the frame.
+// Timestamps are simulated bus time (1 Mbps: 20 us per word plus gaps), not wall clock,
+// so output is reproducible. A burst may run into the next frame, but a message that would
+// start more than one frame late is dropped and counted: an over-capacity schedule loses
+// messages instead of pushing bus time ahead of frame (wall) time. Fields with a
+// sim_pattern are written through the inverse of their decode, so extracted values follow
+// the pattern exactly (to one LSB).
+class BusSimulator {
+public:
+    static constexpr double kMaxDefaultMinorFrameHz = 1000.0;
+
+    explicit BusSimulator(const AppConfig& cfg);
+
+    // Appends the messages of the next minor frame to `out` (not cleared) and returns the count.
+    // Messages of keys outside `accept` still take their bus time but are neither built nor
+    // appended (random fill then differs from an unfiltered run).
+    size_t nextFrame(std::vector<Raw1553Message>& out, const AcceptanceMask* accept = nullptr);
+
+    double minorFrameHz() const { return m_minorFrameHz; }
+    size_t entryCount() const { return m_entries.size(); }
+    // Scheduled message rate summed over all entries
+    double messagesPerSecond() const { return m_messagesPerSecond; }
+
+    // Bus time the schedule needs per second of bus time; at 1 or more it does not fit
+    double scheduledLoad() const { return m_scheduledLoad; }
+
+    uint64_t frames() const { return m_frame; }
+    uint64_t messages() const { return m_messages; }   // on the simulated bus, filtered or not
+    // Messages dropped because the bus was still busy a frame after they were due
+    uint64_t overflowed() const { return m_overflowed; }
+    // Simulated bus time spent transmitting / elapsed
+    double busLoad() const;
+
+private:
+    enum class Pattern : uint8_t { Ramp, Sine, Counter, Random };
+    struct FieldGen {
+        DecodeOp op;
+        Pattern pattern;
+        FieldSim sim;
+    };
+    struct Entry {
+        SimScheduleEntry spec;
+        double creditPerFrame{};
+        double credit{};
+        uint64_t sent{};
+        uint32_t busUs{};
+        std::vector<FieldGen> fields;
+    };
+
+    void fill(Entry& e, Raw1553Message& msg);
+
+    std::vector<Entry> m_entries;
+    std::vector<uint32_t> m_due;    // per entry, messages in the current frame
+    double m_minorFrameHz{50.0};
+    double m_frameUs{20000.0};
+    double m_messagesPerSecond{0.0};
+    double m_scheduledLoad{0.0};
+    bool m_randomFill{true};
+    uint16_t m_increment{0};
+    uint64_t m_frame{0};
+    uint64_t m_messages{0};
+    uint64_t m_overflowed{0};
+    uint64_t m_busCursorUs{0};
+    uint64_t m_busBusyUs{0};
+    std::mt19937 m_rng{1553};
+};
+
+} // namespace ddc
@@ -4,9 +4,37 @@
 #include <unordered_map>
 #include <optional>
 #include <cstdint>
+#include "OverflowPolicy.hpp"
 
 namespace ddc {
 
+constexpr size_t kMaxQueueCapacity = size_t(1) << 24;  // messages per capture ring
+
+enum class OutputFormat { Json, Binary };
+
+// Batch output value of a field: the latest sample, or a statistic over the samples
+// since the previous tick of that output (see LatestValueStore::closeWindow).
+enum class Aggregate : uint8_t { Last, Min, Max, Mean, Count, Rms };
+
+// Simulated value of one field (see BusSimulator). Empty pattern = whatever the
+// message fill (sim_pattern) puts in its words.
+struct FieldSim {
+    std::string pattern;         // ramp | sine | counter | random
+    double min{0.0};             // engineering units
+    double max{100.0};
+    double periodSec{10.0};      // ramp / sine period
+};
+
+// Exception reporting (see ReportFilter): immediate output, and CSV with csv_on_change,
+// only carries a value when it moved past the deadband or its heartbeat is due.
+struct FieldReport {
+    bool enabled{false};         // any of the keys below present; otherwise every value is sent
+    double deadband{0.0};        // absolute change needed (engineering units); 0 = any change
+    double deadbandPct{0.0};     // change needed as percent of the last reported value
+    uint32_t minIntervalMs{0};   // at most one report per interval
+    uint32_t maxIntervalMs{0};   // heartbeat: resend an unchanged value this often (0 = never)
+};
+
 struct FieldSpec {
     std::string name;            // e.g., velocity
     uint16_t rt{};               // Remote Terminal address
@@ -18,25 +46,93 @@ struct FieldSpec {
     bool singleBit{false};
     double lsbScale{1.0};        // scaling factor; if config has lsb_exp = -7 -> scale=2^-7
     std::string type;            // raw,uint,float
+    std::string wireType;        // binary output override: u8,i32,u32,f32,f64 (empty = derived)
+    FieldSim sim;                // simulation only
+    FieldReport report;
+    Aggregate aggregate{Aggregate::Last}; // batch output only
 };
 
 struct StreamConfig {
     std::string name; // grouping name e.g., "transfer_alignment"
     std::vector<FieldSpec> fields;
+    double rateHz{0.0};               // batch output rate for these fields (0 = the sink's)
+};
+
+// One message in the simulated bus schedule.
+struct SimScheduleEntry {
+    uint16_t rt{};
+    uint16_t subAddress{};
+    bool transmit{};
+    uint16_t wordCount{32};
+    double rateHz{50.0};
+    uint8_t channels{0x1};       // bit0 = A, bit1 = B; both alternate A/B
+};
+
+// Expected message rate of one key, checked by the bus analyzer.
+struct ExpectedRate {
+    uint16_t rt{};
+    uint16_t subAddress{};
+    bool transmit{};
+    double rateHz{};
+};
+
+// One capture device / channel. Defaults come from the top-level device / channel_mask /
+// sim_schedule keys; without a "devices" array those form the only device.
+struct DeviceConfig {
+    std::string name{"ACE0"};
+    uint32_t channelMask{0x3};
+    std::vector<SimScheduleEntry> simSchedule;      // simulation: traffic on this device
+};
+
+// One output destination. Defaults come from the top-level udp_host / output_rate_hz /
+// batch / output_format keys; without a "sinks" array those form the only sink.
+struct SinkConfig {
+    std::string host{"127.0.0.1"};                  // unicast or IPv4 multicast group
+    uint16_t port{0};                               // 0 = udp_port (so -p still applies)
+    int multicastTtl{1};
+    std::string multicastInterface;                 // local IPv4 address for outgoing multicast
+    std::vector<std::string> streams;               // stream names to send (empty = all)
+    double rateHz{50.0};                            // batch output rate
+    bool batch{false};
+    OutputFormat format{OutputFormat::Json};
 };
 
 struct AppConfig {
     std::vector<StreamConfig> streams;              // field groups
     uint16_t udpPort{5555};
     std::string udpHost{"127.0.0.1"};
+    int udpSendBuffer{0};                           // SO_SNDBUF bytes (0 = OS default)
     std::string device{"ACE0"};
     uint32_t channelMask{0x3};
     double outputRateHz{50.0};                      // optional aggregated output rate
     bool batchMessages{false};                      // if true, send grouped JSON arrays per tick
     std::string csvPath;                            // if non-empty, write CSV
+    bool csvOnChange{false};                        // CSV rows only for reported values (FieldReport)
+    std::string recordPath;                         // if non-empty, record raw bus traffic
+    std::string replayPath;                         // if non-empty, replay a recording instead of the device
+    double replaySpeed{1.0};                        // 1 = real time, N = Nx, 0 = as fast as possible
     bool simulation{false};                         // run without hardware
     double simRateHz{50.0};                         // simulation message emission rate
-    std::string simPattern{"random"};              // random | increment
+    std::string simPattern{"random"};              // random | increment (fill for words without a field pattern)
+    double simMinorFrameHz{0.0};                    // 0 = fastest schedule rate, capped at 1 kHz
+    std::vector<SimScheduleEntry> simSchedule;      // empty = one entry per field key sharing sim_rate_hz
+    size_t queueCapacity{8192};                     // capture -> processing ring size (messages, <= kMaxQueueCapacity)
+    OverflowPolicy queuePolicy{OverflowPolicy::Block}; // block | drop_newest | drop_oldest
+    OutputFormat outputFormat{OutputFormat::Json};  // json | binary
+    int schemaIntervalMs{1000};                     // binary: schema announcement period
+    std::vector<SinkConfig> sinks;                  // always at least one after loading
+    std::vector<DeviceConfig> devices;              // always at least one after loading
+    uint64_t mergeWindowUs{2000};                   // multi-device reorder window (bus time)
+    size_t workers{0};                              // parallel extraction threads (0 = processing thread)
+    bool latencyStats{true};                        // per-stage latency histograms
+    int statsIntervalMs{0};                         // periodic stats report (0 = at shutdown only)
+    uint16_t statsPort{0};                          // stats datagrams (StatsReporter); 0 = off
+    std::string statsHost;                          // default udp_host
+    int configPollMs{0};                            // hot reload: config file check period (0 = SIGHUP only)
+    bool generatedDecoders{true};                   // use build-time decoders when they match the fields
+    bool acceptanceFilter{true};                    // drop keys without fields before parsing (off while recording or with bus_analyzer)
+    bool busAnalyzer{false};                        // per-key message rate / inter-arrival statistics
+    std::vector<ExpectedRate> expectedRates;        // bus analyzer: schedule to check (missed slots)
 };
 
 class ConfigLoader {
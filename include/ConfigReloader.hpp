@@ -0,0 +1,51 @@
+#pragma once
+#include "Config.hpp"
+#include "ExtractionEngine.hpp"
+#include "OutputFanout.hpp"
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace ddc {
+
+// Hot reload of the field definitions (streams[].fields). The config file is polled for a
+// new modification time, or reloaded on request() (SIGHUP in the application). New engine
+// and output tables are built on the reloader thread and swapped in with RCU, so capture
+// and processing never wait; fields present in both configs keep their latest values.
+// Stream names and rates must stay the same; every other key keeps its startup value.
+class ConfigReloader {
+public:
+    // ok = false: `message` says why the file was not applied
+    using Notify = std::function<void(bool ok, const std::string& message)>;
+
+    ConfigReloader(const AppConfig& running, ExtractionEngine& engine, OutputFanout& output);
+    ~ConfigReloader();
+
+    // pollMs: modification-time check period (0 = only on request())
+    void start(const std::string& path, int pollMs, Notify notify = {});
+    void stop();
+    // Async-signal-safe
+    void request() { m_requested.store(true, std::memory_order_relaxed); }
+
+    // Swaps in the fields of `next`; false (err set) if it changes more than fields.
+    // One caller at a time: the reloader thread once started.
+    bool apply(const AppConfig& next, std::string& err);
+
+    uint64_t reloads() const { return m_reloads.load(std::memory_order_relaxed); }
+    uint64_t failures() const { return m_failures.load(std::memory_order_relaxed); }
+
+private:
+    void run(std::string path, int pollMs, Notify notify);
+
+    const AppConfig& m_running;
+    ExtractionEngine& m_engine;
+    OutputFanout& m_output;
+    std::thread m_thread;
+    std::atomic<bool> m_stop{false};
+    std::atomic<bool> m_requested{false};
+    std::atomic<uint64_t> m_reloads{0};
+    std::atomic<uint64_t> m_failures{0};
+};
+
+} // namespace ddc
@@ -1,27 +1,69 @@
 #pragma once
 #include <string>
 #include <fstream>
-#include <mutex>
-#include <unordered_map>
+#include <atomic>
+#include <thread>
 #include <vector>
 #include "ExtractionEngine.hpp"
+#include "SpscRing.hpp"
 
 namespace ddc {
 
+// CSV writer. writeValues() only copies the values into a fixed-size record on a
+// ring; a background thread keeps the last value per column, formats rows with
+// std::to_chars and writes them in large blocks. writeValues() and flush() must be
+// called from one thread at a time (the ring's single producer).
 class CsvLogger {
 public:
+    static constexpr size_t kRecordValues = 16;     // values per ring record
+    static constexpr size_t kQueueRecords = 4096;
+    static constexpr size_t kBlockBytes = 256 * 1024;
+
+    CsvLogger();
+    ~CsvLogger();
+
+    // Starts the writer thread; call setColumns() first.
     bool open(const std::string& path);
-    // Provide full ordered list of field names (original dotted form) to fix header
+    // Provide full list of field names (original dotted form) in field id order to fix header
     void setColumns(const std::vector<std::string>& names);
-    void writeValues(const std::vector<ExtractedValue>& values);
+    // Values are matched to columns by field id; one call produces one row
+    void writeValues(const FieldValue* values, size_t count);
+    // Blocks until every row written so far has been handed to the file.
     void flush();
+    void close();
+
+    uint64_t rows() const { return m_rows.load(std::memory_order_relaxed); }
+    size_t queueDepth() const { return m_ring.size(); }
+    size_t queueHighWater() const { return m_ring.highWaterMark(); }
+    uint64_t producerStalls() const { return m_ring.stalls(); }
+
 private:
+    struct Record {
+        uint64_t timestamp;
+        uint32_t count;
+        uint8_t endOfRow;   // last record of a row
+        uint8_t flush;      // flush marker (no values)
+        struct { uint32_t fieldId; double value; } values[kRecordValues];
+    };
+
+    void run();
+    void appendRow(uint64_t ts);
+    void writeBlock();
+
     std::ofstream m_ofs;
-    std::mutex m_mtx;
+    SpscRing<Record> m_ring;
+    std::thread m_writer;
+    std::atomic<bool> m_stop{false};
+    std::atomic<uint64_t> m_flushRequests{0};
+    std::atomic<uint64_t> m_flushesDone{0};
+    std::atomic<uint64_t> m_rows{0};
     bool m_headerWritten{false};
     std::vector<std::string> m_columnsOriginal; // dotted names
     std::vector<std::string> m_columnsCsv;      // converted names ('.' -> '/')
-    std::unordered_map<std::string, double> m_lastValues; // last seen values
+    // Writer thread only
+    std::vector<double> m_lastValues;           // last seen value per column
+    std::vector<uint8_t> m_seen;                // column has a value yet
+    std::string m_block;                        // formatted rows awaiting write
 };
 
 } // namespace ddc
@@ -1,9 +1,14 @@
 #pragma once
 #include "Config.hpp"
 #include "MessageParser.hpp"
+#include "ExtractionPlan.hpp"
+#include "LatestValueStore.hpp"
+#include "GeneratedDecoders.hpp"
+#include "Rcu.hpp"
 #include <nlohmann/json_fwd.hpp>
-#include <unordered_map>
-#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 namespace ddc {
 
@@ -14,23 +19,81 @@ struct ExtractedValue {
     uint64_t timestamp{}; // source message timestamp
 };
 
+// One generation of the field tables. Replaced as a whole on config reload; only the
+// values in `store` change while it is installed.
+struct ExtractionTables {
+    ExtractionTables(const AppConfig& cfg, const ExtractionPlan* previous, size_t windows);
+
+    // Store groups holding any of `fieldIds` (empty = all groups), for partial snapshots
+    std::vector<uint32_t> groupsOf(const std::vector<uint32_t>& fieldIds) const;
+
+    ExtractionPlan plan;
+    LatestValueStore store;
+    uint64_t generation{0};
+    const GeneratedDecoders* generated{nullptr};  // stands in for plan's ops (same signature)
+};
+
+// The current tables sit behind an atomic pointer (RCU): threads that use the engine while
+// a reload may run register with rcu() and call quiescent() between messages, so a reload
+// swaps the tables without ever blocking them. Without reloads none of that is needed.
 class ExtractionEngine {
 public:
     explicit ExtractionEngine(const AppConfig& cfg);
 
-    // Feed a parsed message; returns list of newly extracted values (raw instantaneous)
+    // Feed a parsed message; writes up to `capacity` values into the caller-owned
+    // buffer and returns the count. Does not allocate. A buffer of
+    // maxValuesPerMessage() entries never truncates. Messages of different keys may be
+    // extracted concurrently; one key must stay on one thread (see ExtractionPool).
+    size_t extract(const ParsedMessage& msg, FieldValue* out, size_t capacity);
+    // Same, growing `out` first when a reload raised maxValuesPerMessage(), so nothing is
+    // truncated across a reload (allocates only then).
+    size_t extract(const ParsedMessage& msg, std::vector<FieldValue>& out);
+
+    // Convenience wrapper around extract() that resolves names (allocates per call)
     std::vector<ExtractedValue> process(const ParsedMessage& msg);
 
+    // The accessors below read the current tables; references stay valid until the
+    // caller's next quiescent point.
+    const ExtractionTables& tables() const { return *m_tables.load(std::memory_order_acquire); }
+    size_t fieldCount() const { return plan().fields().size(); }
+    size_t maxValuesPerMessage() const { return plan().maxOpsPerKey(); }
+    const std::vector<FieldSpec>& fields() const { return plan().fields(); }
+    const FieldSpec& field(uint32_t id) const { return plan().fields()[id]; }
+    const std::string& fieldName(uint32_t id) const { return plan().fields()[id].name; }
+    const ExtractionPlan& plan() const { return tables().plan; }
+    // Build-time decoders in use (generated_decoders and a matching config), else nullptr
+    const GeneratedDecoders* generated() const { return tables().generated; }
+
+    // Lock-free copy of the latest values; fields from one message are always consistent.
+    void snapshot(ValueSnapshot& out) const { tables().store.snapshot(out); }
+    // Same, with aggregated fields over the window since the last call for `window`.
+    // One window per batch output group (numbered from 0); a single caller per window.
+    void closeWindow(size_t window, ValueSnapshot& out, const std::vector<uint32_t>* groups = nullptr) const {
+        tables().store.closeWindow(window, out, groups);
+    }
+    std::vector<uint32_t> groupsOf(const std::vector<uint32_t>& fieldIds) const { return tables().groupsOf(fieldIds); }
+    size_t windowCount() const { return tables().store.windowCount(); }
+
+    // Config reload, off the hot path and from one thread at a time. prepare() builds tables
+    // for `cfg`'s fields (ids kept by name, see ExtractionPlan) holding the latest values of
+    // the fields both configs share (values published between the two calls reach only the
+    // old tables, until the next message of their key); install() makes them current and
+    // returns the previous tables, to be freed after rcu().synchronize().
+    std::unique_ptr<ExtractionTables> prepare(const AppConfig& cfg) const;
+    std::unique_ptr<ExtractionTables> install(std::unique_ptr<ExtractionTables> next);
+    // Bumped by install(); hot-path threads compare it to notice a reload cheaply.
+    uint64_t generation() const { return m_generation.load(std::memory_order_acquire); }
+    RcuDomain& rcu() const { return m_rcu; }
+
     // Build JSON payload depending on batch vs immediate
     nlohmann::json buildJsonSnapshot();
 
 private:
-    const AppConfig& m_cfg;
-    std::unordered_map<MsgKey, std::vector<FieldSpec>, MsgKeyHash> m_lookup;
-
-    std::mutex m_mtx;
-    // Latest values by field name
-    std::unordered_map<std::string, ExtractedValue> m_latest;
+    size_t m_windows;                                   // aggregation windows per store
+    std::unique_ptr<ExtractionTables> m_current;        // owner of the installed tables
+    std::atomic<ExtractionTables*> m_tables;
+    std::atomic<uint64_t> m_generation{0};
+    mutable RcuDomain m_rcu;
 };
 
 } // namespace ddc
@@ -0,0 +1,131 @@
+#pragma once
+#include "Config.hpp"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace ddc {
+
+// Dense (RT,SA,T/R) key space: 32 RT x 32 SA x 2 directions.
+constexpr size_t kMsgKeySpace = 2048;
+
+inline constexpr bool msgKeyInRange(uint16_t rt, uint16_t sa) { return rt < 32 && sa < 32; }
+inline constexpr size_t msgKeyIndex(uint16_t rt, uint16_t sa, bool tx) {
+    return (static_cast<size_t>(rt) << 6) | (static_cast<size_t>(sa) << 1) | (tx ? 1u : 0u);
+}
+
+enum class DecodeOpCode : uint8_t {
+    Bit,        // single bit of one word
+    Unsigned16, // one word, unsigned
+    Signed16,   // one word, two's complement
+    UnsignedN,  // N words combined, first word is MSW
+    SignedN,    // N words combined and sign-extended
+    Ieee754,    // two words combined into an IEEE754 float32
+};
+
+// One field decoder, resolved from a FieldSpec at load time.
+struct DecodeOp {
+    DecodeOpCode op{DecodeOpCode::Unsigned16};
+    uint8_t wordOffset{};   // 0-based index of first word
+    uint8_t wordCount{};    // words combined (N-word ops)
+    uint8_t shift{};        // bit index (Bit op)
+    uint8_t minWords{};     // data words required for the field to be in bounds
+    uint32_t fieldId{};     // index into ExtractionPlan::fields()
+    uint64_t mask{};        // Bit: mask after shift; N-word: value mask
+    uint64_t signBit{};     // SignedN: sign bit of the combined value
+    double scale{1.0};      // combined scale (lsbScale)
+};
+
+// Allocation-free extraction result; resolve the name via ExtractionEngine::fieldName(fieldId)
+struct FieldValue {
+    uint32_t fieldId{};
+    double value{};
+    uint64_t timestamp{}; // source message timestamp
+};
+
+// Range of ops for one (RT,SA,T/R) key. Keys with fields get a compact group id;
+// all fields decoded from one message share it.
+struct DecodeSlot {
+    uint32_t first{};
+    uint32_t count{};
+    uint32_t group{};
+};
+
+constexpr uint32_t kNoGroup = 0xFFFFFFFFu;
+
+inline double decodeField(const DecodeOp& op, const uint16_t* words) {
+    const uint16_t* w = words + op.wordOffset;
+    switch (op.op) {
+    case DecodeOpCode::Bit:
+        return static_cast<double>((w[0] >> op.shift) & op.mask) * op.scale;
+    case DecodeOpCode::Unsigned16:
+        return static_cast<double>(w[0]) * op.scale;
+    case DecodeOpCode::Signed16:
+        return static_cast<double>(static_cast<int16_t>(w[0])) * op.scale;
+    case DecodeOpCode::Ieee754: {
+        uint32_t raw = (static_cast<uint32_t>(w[0]) << 16) | w[1];
+        float f; std::memcpy(&f, &raw, sizeof(f));
+        return static_cast<double>(f) * op.scale;
+    }
+    default: break;
+    }
+    uint64_t accum = 0;
+    for (int i = 0; i < op.wordCount; ++i) accum = (accum << 16) | w[i];
+    accum &= op.mask;
+    if (op.op == DecodeOpCode::SignedN) {
+        int64_t s = static_cast<int64_t>(accum ^ op.signBit) - static_cast<int64_t>(op.signBit);
+        return static_cast<double>(s) * op.scale;
+    }
+    return static_cast<double>(accum) * op.scale;
+}
+
+// Inverse of decodeField: writes the words that decode to `value` (rounded to the nearest
+// LSB and clamped to the field's range). Other bits of a Bit field's word are preserved.
+void encodeField(const DecodeOp& op, double value, uint16_t* words);
+// Same, from a raw integer truncated to the field width (counters wrap instead of clamping).
+void encodeFieldRaw(const DecodeOp& op, uint64_t raw, uint16_t* words);
+
+// Config compiled into a flat dispatch table indexed by msgKeyIndex().
+class ExtractionPlan {
+public:
+    // With `previous` (config reload), a field keeps the id it had there (matched by name),
+    // new fields are appended and removed ones stay as retired ids that never decode, so
+    // ids already in flight keep their meaning.
+    explicit ExtractionPlan(const AppConfig& cfg, const ExtractionPlan* previous = nullptr);
+
+    const DecodeSlot& slot(size_t keyIndex) const { return m_slots[keyIndex]; }
+    const DecodeOp* ops() const { return m_ops.data(); }
+
+    // Field specs in id order (stream order, then field order within a stream; after a
+    // reload, ids of the previous plan first)
+    const std::vector<FieldSpec>& fields() const { return m_fields; }
+    // Field ids of each config stream, in config order
+    const std::vector<std::vector<uint32_t>>& streamFields() const { return m_streamFields; }
+    bool retired(uint32_t id) const { return m_retired[id] != 0; }
+    // Largest number of ops on any single key; sizes caller output buffers
+    size_t maxOpsPerKey() const { return m_maxOpsPerKey; }
+    // Number of keys that have fields
+    size_t groupCount() const { return m_groupCount; }
+    // Group of each field id (kNoGroup if the field can never be decoded)
+    const std::vector<uint32_t>& fieldGroups() const { return m_fieldGroups; }
+
+    // Hash of the field names and the ops of every key; generated decoders (see
+    // GeneratedDecoders.hpp) stand in for this plan only when built with the same signature.
+    uint64_t signature() const;
+
+    static DecodeOp compile(const FieldSpec& f, uint32_t fieldId, bool& valid);
+
+private:
+    std::array<DecodeSlot, kMsgKeySpace> m_slots{};
+    std::vector<DecodeOp> m_ops;
+    std::vector<FieldSpec> m_fields;
+    std::vector<std::vector<uint32_t>> m_streamFields;
+    std::vector<uint8_t> m_retired;
+    size_t m_maxOpsPerKey{0};
+    size_t m_groupCount{0};
+    std::vector<uint32_t> m_fieldGroups;
+};
+
+} // namespace ddc
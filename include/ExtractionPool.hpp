@@ -0,0 +1,90 @@
+#pragma once
+#include "ExtractionEngine.hpp"
+#include "LatencyStats.hpp"
+#include "Metrics.hpp"
+#include "SpscRing.hpp"
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace ddc {
+
+// Parallel parse + extract. Every (RT,SA,T/R) key with fields is owned by one worker, so
+// values of a key are extracted (and written to the engine's store, which takes one
+// writer per key) in arrival order. Keys are spread to balance decode ops per worker.
+// The dispatching thread hands messages over on per-worker SPSC rings; when values are
+// forwarded, workers pass them back on per-worker SPSC rings to a gather thread that
+// calls the value sink with one message's values at a time. Workers and the gather thread
+// are readers of the engine's RCU domain, so config reloads never stall them.
+class ExtractionPool {
+public:
+    // captureNs: Raw1553Message::hostTimeNs of the message the values came from
+    using ValueSink = std::function<void(const FieldValue* values, size_t count, uint64_t captureNs)>;
+    using IdleHook = std::function<void()>;
+
+    static constexpr size_t kChunkValues = 16;
+
+    // forwardValues: false when only snapshots are needed (batch output without CSV)
+    ExtractionPool(ExtractionEngine& engine, size_t workers, size_t queueCapacity, bool forwardValues);
+    ~ExtractionPool();
+
+    // Queue / parse / extract latencies, one shard per worker. Call before start().
+    void setLatency(LatencyStats* stats);
+    // Parse errors and per-key message / value counts, one shard per worker. Call before start().
+    void setMetrics(Metrics* metrics);
+    // onValues runs on the gather thread; onIdle whenever it has caught up with the workers.
+    void start(ValueSink onValues = {}, IdleHook onIdle = {});
+    // Single dispatching thread. False if no field decodes from the message's key. Keys added
+    // by a config reload are assigned to workers on the first dispatch after it.
+    bool dispatch(const Raw1553Message& raw);
+    // Drains every queue, then joins the workers and the gather thread.
+    void stop();
+
+    size_t workerCount() const { return m_workers.size(); }
+    uint64_t processed(size_t worker) const { return m_workers[worker]->processed.load(std::memory_order_relaxed); }
+    uint64_t processedTotal() const;
+    const SpscRing<Raw1553Message>& input(size_t worker) const { return m_workers[worker]->input; }
+
+private:
+    struct Chunk {
+        uint32_t count;
+        uint32_t endOfMessage;
+        uint64_t captureNs;
+        FieldValue values[kChunkValues];
+    };
+    struct Worker {
+        Worker(size_t capacity) : input(capacity), output(capacity) {}
+        SpscRing<Raw1553Message> input;
+        SpscRing<Chunk> output;
+        std::thread thread;
+        std::atomic<uint64_t> processed{0};
+        LatencyStats::Shard* latency{nullptr};
+        Metrics::Shard* metrics{nullptr};
+        RcuDomain::Reader* reader{nullptr};
+    };
+
+    void assignKeys(const ExtractionPlan& plan);
+    void runWorker(Worker& w);
+    void runGather();
+
+    static constexpr uint16_t kNoWorker = 0xFFFF;
+
+    ExtractionEngine& m_engine;
+    bool m_forward;
+    std::array<uint16_t, kMsgKeySpace> m_owner{};   // worker per key, kNoWorker if no fields
+    std::vector<size_t> m_load;                     // decode ops per worker
+    uint64_t m_generation{0};                       // engine tables m_owner covers
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::thread m_gather;
+    RcuDomain::Reader* m_gatherReader{nullptr};
+    ValueSink m_onValues;
+    IdleHook m_onIdle;
+    std::atomic<bool> m_stopWorkers{false};
+    std::atomic<bool> m_stopGather{false};
+    bool m_running{false};
+};
+
+} // namespace ddc
@@ -0,0 +1,57 @@
+#pragma once
+#include "ExtractionPlan.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace ddc {
+
+// Field decoders compiled from one fixed config at build time (CMake option
+// DDC_GENERATED_DECODERS, generator in tools/DecoderCodegen.cpp): a switch over the
+// (RT,SA,T/R) key into one function per key with every field's decode inlined and its
+// constants folded. ExtractionEngine uses them instead of the DecodeOp table when the
+// running plan has the same signature, and falls back to the table otherwise.
+struct GeneratedDecoders {
+    uint64_t signature;                 // ExtractionPlan::signature() of the source config
+    size_t fieldCount;
+    const char* const* fieldNames;      // by field id
+    const char* source;                 // config file the decoders were generated from
+    // Decodes a message of key `key` (msgKeyIndex) into `out`, which must hold
+    // maxOpsPerKey() values; fields beyond `wordCount` are skipped. Returns the count.
+    size_t (*decode)(size_t key, const uint16_t* words, size_t wordCount, uint64_t timestamp, FieldValue* out);
+};
+
+// The decoders built into this binary, or nullptr
+const GeneratedDecoders* generatedDecoders();
+
+namespace gen {
+
+// decodeField() with the op as template arguments, so each call site compiles to the
+// few instructions its field needs. The scale is applied by the caller.
+template <DecodeOpCode Op, unsigned Offset, unsigned Count, unsigned Shift, uint64_t Mask, uint64_t SignBit>
+inline double decodeRaw(const uint16_t* words) {
+    const uint16_t* w = words + Offset;
+    if constexpr (Op == DecodeOpCode::Bit) {
+        return static_cast<double>((w[0] >> Shift) & Mask);
+    } else if constexpr (Op == DecodeOpCode::Unsigned16) {
+        return static_cast<double>(w[0]);
+    } else if constexpr (Op == DecodeOpCode::Signed16) {
+        return static_cast<double>(static_cast<int16_t>(w[0]));
+    } else if constexpr (Op == DecodeOpCode::Ieee754) {
+        uint32_t raw = (static_cast<uint32_t>(w[0]) << 16) | w[1];
+        float f; std::memcpy(&f, &raw, sizeof(f));
+        return static_cast<double>(f);
+    } else {
+        uint64_t accum = 0;
+        for (unsigned i = 0; i < Count; ++i) accum = (accum << 16) | w[i];
+        accum &= Mask;
+        if constexpr (Op == DecodeOpCode::SignedN)
+            return static_cast<double>(static_cast<int64_t>(accum ^ SignBit) - static_cast<int64_t>(SignBit));
+        else
+            return static_cast<double>(accum);
+    }
+}
+
+} // namespace gen
+
+} // namespace ddc
@@ -0,0 +1,38 @@
+#pragma once
+#include "ExtractionPlan.hpp"
+#include "JsonFormatter.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ddc {
+
+// Immediate-mode JSON encoder: one object per extracted value,
+// {"datetime":..,<nested field>,"seq":..,"timestamp":..,"timestamp_us":..} in
+// nlohmann's sorted key order. Each field's layout (escaped keys, nesting braces,
+// metadata placement) is precomputed, so encoding only formats numbers into a
+// reusable buffer. Output is byte-identical to building the object with nlohmann.
+class ImmediateEncoder {
+public:
+    explicit ImmediateEncoder(const std::vector<std::string>& fieldNames);
+
+    // Not thread-safe: one caller per instance.
+    void encode(const FieldValue& v, uint64_t seq, std::string& out);
+
+private:
+    enum class Slot : uint8_t { Value, TimestampUs, Timestamp, Datetime, Seq };
+
+    // text is split at `offset` positions; slot i is written after text[..offset[i]]
+    struct Layout {
+        std::string text;
+        std::array<uint32_t, 5> offset{};
+        std::array<Slot, 5> slot{};
+        uint8_t slotCount{0};
+    };
+
+    std::vector<Layout> m_layouts; // by field id
+    IsoSecondClock m_clock;
+};
+
+} // namespace ddc
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstdint>
+#include <ctime>
 #include <string>
 #include <nlohmann/json.hpp>
 
@@ -8,6 +10,26 @@ class JsonFormatter {
 public:
     static std::string compact(const nlohmann::json& j) { return j.dump(); }
     static std::string pretty(const nlohmann::json& j, int indent = 2) { return j.dump(indent); }
+
+    // Append helpers for template-based encoders. Output is byte-identical to what
+    // nlohmann::json::dump() produces for the same value. No allocation once `out`
+    // has enough capacity.
+    static void appendDouble(std::string& out, double v);
+    static void appendUnsigned(std::string& out, uint64_t v);
+};
+
+// Caches the ISO 8601 UTC text ("YYYY-MM-DDTHH:MM:SSZ") of the current wall-clock
+// second so callers only pay for gmtime/formatting once per second.
+class IsoSecondClock {
+public:
+    static constexpr size_t kLength = 20;
+
+    // Text for the current system_clock second (not NUL-terminated, kLength chars)
+    const char* now();
+
+private:
+    std::time_t m_second{-1};
+    char m_text[kLength + 1]{};
 };
 
 } // namespace ddc
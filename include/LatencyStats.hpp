@@ -0,0 +1,108 @@
+#pragma once
+#include "Atomics.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ddc {
+
+// Host clock used for Raw1553Message::hostTimeNs and every stage timing
+inline uint64_t steadyNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Queue:    capture -> dequeued by the processing thread (or a pool worker)
+// Parse, Extract, Encode (immediate datagrams of one message), Send (one flush to the kernel)
+// EndToEnd: capture -> the flush that handed the message's datagrams to the kernel
+enum class LatencyStage : uint8_t { Queue, Parse, Extract, Encode, Send, EndToEnd };
+constexpr size_t kLatencyStageCount = 6;
+const char* latencyStageName(LatencyStage stage);
+
+// Merged view of one or more histograms.
+struct LatencySummary {
+    uint64_t count{0};
+    double meanUs{0.0};
+    double p50Us{0.0};
+    double p99Us{0.0};
+    double p999Us{0.0};
+    double maxUs{0.0};
+};
+
+// Log-linear histogram in nanoseconds (HDR style): exact below 32 ns, then 32 sub-buckets per
+// power of two (within 3.2%), saturating above an hour. Fixed memory; one writer, any
+// number of readers, no locks (counts are relaxed atomics updated with plain load + store).
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBits = 5;
+    static constexpr uint64_t kSubCount = 1ull << kSubBits;
+    static constexpr unsigned kMaxExponent = 41;
+    // The exact range, then one group of sub-buckets per exponent kSubBits..kMaxExponent
+    static constexpr size_t kBucketCount = (kMaxExponent - kSubBits + 2) * kSubCount;
+
+    void record(uint64_t ns) {
+        singleWriterAdd(m_counts[bucketOf(ns)], 1);
+        singleWriterAdd(m_total, 1);
+        singleWriterAdd(m_sumNs, ns);
+        if (ns > m_maxNs.load(std::memory_order_relaxed)) m_maxNs.store(ns, std::memory_order_relaxed);
+    }
+
+    // Adds this histogram's counts into `counts` (kBucketCount entries).
+    void mergeInto(std::vector<uint64_t>& counts, uint64_t& total, uint64_t& sumNs, uint64_t& maxNs) const;
+
+    static size_t bucketOf(uint64_t ns);
+    // Midpoint of a bucket, in ns
+    static double bucketValue(size_t bucket);
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> m_counts{};
+    std::atomic<uint64_t> m_total{0};
+    std::atomic<uint64_t> m_sumNs{0};
+    std::atomic<uint64_t> m_maxNs{0};
+};
+
+// Per-thread latency shards, merged on read. Each recording thread gets its own shard
+// (registered before it starts), so recording never contends.
+class LatencyStats {
+public:
+    class Shard {
+    public:
+        // Short per-message stages are timed on one message in kSampleEvery to keep clock
+        // reads off most messages; queue, send and end-to-end are recorded for every one.
+        static constexpr uint32_t kSampleEvery = 16;
+        bool sample() { return ++m_tick % kSampleEvery == 0; }
+
+        void record(LatencyStage stage, uint64_t ns) { m_stages[static_cast<size_t>(stage)].record(ns); }
+        // Records now - startNs (0 = unknown start, skipped) and returns now
+        uint64_t since(LatencyStage stage, uint64_t startNs) {
+            uint64_t now = steadyNowNs();
+            if (startNs && now >= startNs) record(stage, now - startNs);
+            return now;
+        }
+        const LatencyHistogram& stage(LatencyStage s) const { return m_stages[static_cast<size_t>(s)]; }
+
+    private:
+        std::array<LatencyHistogram, kLatencyStageCount> m_stages;
+        uint32_t m_tick{0};
+    };
+
+    // Registers a shard for one thread; the pointer stays valid for the lifetime of this object.
+    Shard* addShard(const std::string& name);
+    size_t shardCount() const;
+
+    LatencySummary summary(LatencyStage stage) const;
+    // One line per stage with samples: "queue n=.. p50=..us p99=.. p99.9=.. max=.."
+    std::string report() const;
+
+private:
+    mutable std::mutex m_mtx;     // registry only
+    std::vector<std::unique_ptr<Shard>> m_shards;
+    std::vector<std::string> m_names;
+};
+
+} // namespace ddc
@@ -0,0 +1,100 @@
+#pragma once
+#include "ExtractionPlan.hpp"
+#include "Atomics.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ddc {
+
+// Reader-owned copy of the latest values, indexed by field id.
+struct ValueSnapshot {
+    std::vector<double> values;
+    std::vector<uint64_t> timestamps;
+    std::vector<uint8_t> valid;     // field has been decoded at least once
+    uint64_t latestTimestamp{0};    // newest timestamp across valid fields
+
+    void resize(size_t fieldCount) {
+        values.resize(fieldCount);
+        timestamps.resize(fieldCount);
+        valid.resize(fieldCount);
+    }
+};
+
+// Dense latest-value store indexed by field id. Fields decoded from the same message
+// form a group with its own sequence lock: the (single) writer of a group never
+// blocks, and readers retry a group until they copy it without a concurrent write,
+// so every field of a group in a snapshot comes from the same message instance.
+//
+// Fields with an aggregate mode also accumulate count / sum / sum of squares / min / max
+// per aggregation window (one per batch output), in O(1) per sample. Each window has an
+// epoch and two accumulator sets: writers add to the set of the current epoch (resetting
+// it on the first sample of a new epoch), and closeWindow() bumps the epoch and then reads
+// the set it just closed, so nothing is stored per sample and the writer never waits.
+class LatestValueStore {
+public:
+    explicit LatestValueStore(const ExtractionPlan& plan, size_t windows = 0);
+
+    // Writer side. All values must belong to `group`; one writer per group at a time.
+    void publish(uint32_t group, const FieldValue* values, size_t count);
+
+    // Reader side: lock-free, consistent per group. Resizes `out` on first use only.
+    // With `groups`, only those groups are copied (latestTimestamp covers just them).
+    void snapshot(ValueSnapshot& out, const std::vector<uint32_t>* groups = nullptr) const;
+    // Snapshot with aggregated fields set to their value over the window since the previous
+    // call for `window` (one reader per window). A field without samples in the window keeps
+    // its last value, count reports 0. NaN samples are not aggregated.
+    void closeWindow(size_t window, ValueSnapshot& out, const std::vector<uint32_t>* groups = nullptr) const;
+
+    // Before the store is shared (config reload): takes the values valid in `from`, by field
+    // id, for fields that still decode. Not aggregated.
+    void seed(const ValueSnapshot& from);
+
+    size_t fieldCount() const { return m_fieldCount; }
+    size_t windowCount() const { return m_windowCount; }
+
+private:
+    struct Slot {
+        std::atomic<double> value{0.0};
+        std::atomic<uint64_t> timestamp{0};
+        std::atomic<uint8_t> valid{0};
+    };
+    struct alignas(kCacheLine) Group {
+        std::atomic<uint64_t> seq{0}; // odd while a write is in progress
+    };
+    struct Accum {
+        std::atomic<uint64_t> epoch{~0ull};  // window epoch these sums belong to
+        std::atomic<uint64_t> count{0};
+        std::atomic<double> sum{0.0};
+        std::atomic<double> sumSq{0.0};
+        std::atomic<double> min{0.0};
+        std::atomic<double> max{0.0};
+    };
+    static constexpr uint32_t kNoAggregate = 0xFFFFFFFFu;
+
+    uint64_t readGroup(size_t g, ValueSnapshot& out) const;
+    void accumulate(uint32_t agg, double value);
+    Accum& accum(size_t window, uint64_t epoch, uint32_t agg) const {
+        return m_accums[(window * 2 + (epoch & 1)) * m_aggCount + agg];
+    }
+
+    size_t m_fieldCount{0};
+    std::unique_ptr<Slot[]> m_slots;
+    std::unique_ptr<Group[]> m_groups;
+    size_t m_groupCount{0};
+    // Field ids of each group, CSR layout: m_groupFields[m_groupStart[g] .. m_groupStart[g+1])
+    std::vector<uint32_t> m_groupStart;
+    std::vector<uint32_t> m_groupFields;
+    // Aggregation: index per field id (kNoAggregate = last value only), mode per index
+    std::vector<uint32_t> m_aggIndex;
+    std::vector<Aggregate> m_aggMode;
+    std::vector<uint32_t> m_aggGroups;                  // groups holding aggregated fields
+    std::vector<uint8_t> m_groupAggregated;             // per group
+    size_t m_aggCount{0};
+    size_t m_windowCount{0};
+    std::unique_ptr<std::atomic<uint64_t>[]> m_epochs;  // per window
+    std::unique_ptr<Accum[]> m_accums;                  // [window][epoch & 1][agg]
+};
+
+} // namespace ddc
@@ -1,10 +1,24 @@
 #pragma once
 #include "B1553Monitor.hpp"
 #include <nlohmann/json_fwd.hpp>
-#include <optional>
 
 namespace ddc {
 
+// Non-owning view of a message's data words
+struct WordSpan {
+    const uint16_t* ptr{};
+    size_t count{};
+
+    const uint16_t* data() const { return ptr; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    uint16_t operator[](size_t i) const { return ptr[i]; }
+    const uint16_t* begin() const { return ptr; }
+    const uint16_t* end() const { return ptr + count; }
+};
+
+// Decoded header plus a view into the source Raw1553Message payload;
+// only valid while that message is alive.
 struct ParsedMessage {
     uint16_t rt{};
     uint16_t sa{};
@@ -12,13 +26,15 @@ struct ParsedMessage {
     bool modeCode{};
     bool transmit{}; // direction relative to RT
     uint16_t channel{};
+    uint16_t bus{};  // capturing device
     uint64_t timestamp{};
-    std::vector<uint16_t> data;
+    WordSpan data;
 };
 
 class MessageParser {
 public:
-    std::optional<ParsedMessage> parse(const Raw1553Message& raw) const;
+    // Fills `out` without copying the payload; returns false if the message is unusable.
+    bool parse(const Raw1553Message& raw, ParsedMessage& out) const;
     nlohmann::json toJson(const ParsedMessage& msg) const;
 };
 
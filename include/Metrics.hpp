@@ -0,0 +1,70 @@
+#pragma once
+#include "ExtractionPlan.hpp"
+#include "Atomics.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ddc {
+
+enum class Counter : uint8_t {
+    Captured,        // delivered by a monitor
+    CaptureDropped,  // rejected by a full capture queue (drop policies)
+    Processed,       // taken off the capture queues for parsing
+    ParseErrors,
+    Unmatched,       // parsed, but no field decodes from its key
+    Extracted,       // produced at least one value
+    Values,
+    BoundsMisses,    // fields skipped because the message had too few data words
+};
+constexpr size_t kCounterCount = 8;
+const char* counterName(Counter c);
+
+// Pipeline counters. Each thread counts into its own cache-line-aligned shard (plain
+// load + store on relaxed atomics, no read-modify-write); readers sum the shards.
+class Metrics {
+public:
+    class alignas(kCacheLine) Shard {
+    public:
+        void add(Counter c, uint64_t n = 1) { singleWriterAdd(m_counters[static_cast<size_t>(c)], n); }
+        // One parsed message of `key`: `ops` fields decode from the key, `values` were produced
+        void message(size_t key, size_t ops, size_t values) {
+            singleWriterAdd(m_keyMessages[key], 1);
+            if (ops == 0) { add(Counter::Unmatched); return; }
+            if (values) add(Counter::Extracted);
+            add(Counter::Values, values);
+            if (values < ops) {
+                add(Counter::BoundsMisses, ops - values);
+                singleWriterAdd(m_keyBoundsMisses[key], ops - values);
+            }
+        }
+
+    private:
+        friend class Metrics;
+        std::array<std::atomic<uint64_t>, kCounterCount> m_counters{};
+        alignas(kCacheLine) std::array<std::atomic<uint64_t>, kMsgKeySpace> m_keyMessages{};
+        std::array<std::atomic<uint64_t>, kMsgKeySpace> m_keyBoundsMisses{};
+    };
+
+    struct KeyTotals {
+        uint64_t messages{0};
+        uint64_t boundsMisses{0};
+    };
+
+    // One shard per counting thread, registered before it starts; valid for this object's lifetime.
+    Shard* addShard();
+
+    uint64_t total(Counter c) const;
+    // Per key index (msgKeyIndex); resized to kMsgKeySpace
+    void keyTotals(std::vector<KeyTotals>& out) const;
+
+private:
+    mutable std::mutex m_mtx;     // registry only
+    std::vector<std::unique_ptr<Shard>> m_shards;
+};
+
+} // namespace ddc
@@ -0,0 +1,129 @@
+#pragma once
+#include "BinaryEncoder.hpp"
+#include "Config.hpp"
+#include "ExtractionEngine.hpp"
+#include "ImmediateEncoder.hpp"
+#include "LatencyStats.hpp"
+#include "RateScheduler.hpp"
+#include "SnapshotSerializer.hpp"
+#include "UdpPublisher.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ddc {
+
+// Sends extracted values to every configured sink. Sinks with the same mode, format,
+// stream selection (and rate, in batch mode) form one output group: its payload is
+// encoded once per value / tick and the same bytes go to each member. seq counts per group.
+// A batch group is ticked once per distinct rate among its streams (a stream's rate_hz,
+// else the sink's), each tick carrying only the fields of the streams at that rate; all
+// batch ticks run from one RateScheduler thread.
+//
+// Everything that depends on the field list (names, encoders, serializers, store groups)
+// lives in one Tables generation behind an atomic pointer, replaced by reload() and read
+// lock-free by the publishing, batch and schema threads (RCU, see ExtractionEngine).
+class OutputFanout {
+public:
+    OutputFanout(const AppConfig& cfg, const ExtractionEngine& engine);
+    ~OutputFanout();
+
+    // Opens every sink; on failure `err` names the sink.
+    bool open(std::string& err);
+    // Starts batch and schema-announcement threads.
+    void start();
+    // Immediate-mode groups; call from the processing thread only. captureNs (the message's
+    // hostTimeNs, 0 = unknown) is used for the end-to-end latency at the next flush().
+    void publish(const FieldValue* values, size_t count, uint64_t captureNs = 0);
+    // Hands queued immediate datagrams to the kernel.
+    void flush();
+    // Encode / send / end-to-end latencies of immediate output, written by the publishing thread.
+    void setLatency(LatencyStats::Shard* shard);
+    // Stops threads, flushes and closes every sink.
+    void stop();
+    // Config reload: builds the encoders for `next` (prepared by the engine, installed after
+    // this) and swaps them in. The previous ones are freed by freeRetired(), to be called
+    // after the engine's rcu().synchronize(). Same thread as the engine's prepare().
+    void reload(const ExtractionTables& next);
+    void freeRetired();
+
+    size_t sinkCount() const { return m_sinks.size(); }
+    size_t groupCount() const { return m_groups.size(); }
+    bool hasImmediate() const { return m_hasImmediate; }
+    const SinkConfig& sink(size_t i) const { return m_sinks[i]; }
+    uint16_t sinkPort(size_t i) const { return m_sinks[i].port ? m_sinks[i].port : m_cfg.udpPort; }
+    UdpStats sinkStats(size_t i) const { return m_publishers[i]->stats(); }
+    // Batch schedule entries; stats are valid after stop()
+    size_t batchTickCount() const { return m_ticks.size(); }
+    const std::string& batchTickName(size_t i) const { return m_ticks[i].name; }
+    double batchTickRate(size_t i) const { return m_ticks[i].rateHz; }
+    RateScheduler::Stats batchTickStats(size_t i) const { return m_scheduler.stats(i); }
+
+private:
+    struct Group {
+        bool batch{false};
+        OutputFormat format{OutputFormat::Json};
+        double rateHz{0};
+        std::vector<std::string> streams;   // selection of the first sink (empty = all)
+        std::vector<uint32_t> fieldIds;     // sorted; empty = all fields
+        std::vector<size_t> sinks;          // indices into m_publishers
+        uint64_t seq{0};
+    };
+    // One rate of one batch group
+    struct BatchTick {
+        Group* group{nullptr};
+        double rateHz{0};
+        std::string name;                   // stream names, for stats
+        size_t window{0};                   // aggregation window in the engine
+        std::vector<size_t> streams;        // config stream indices; empty = every field
+        ValueSnapshot snap;
+        std::string payload;
+    };
+    // Field-dependent state of one batch tick
+    struct TickTables {
+        std::vector<uint32_t> groups;       // store groups to snapshot
+        std::unique_ptr<SnapshotSerializer> json;
+        std::unique_ptr<BinaryEncoder> binary;
+    };
+    struct Tables {
+        Tables(const ExtractionTables& engine, std::vector<std::string> names)
+            : engine(&engine), fieldNames(std::move(names)), immediate(fieldNames), binary(engine.plan.fields()) {}
+        const ExtractionTables* engine;
+        std::vector<std::string> fieldNames;
+        ImmediateEncoder immediate;          // shared by immediate JSON groups
+        BinaryEncoder binary;                // immediate values and schema (all fields)
+        std::vector<std::vector<uint8_t>> included;  // per group, per field id (immediate filter)
+        std::vector<TickTables> ticks;       // per batch tick
+    };
+
+    void addBatchTicks(Group& g);
+    std::unique_ptr<Tables> build(const ExtractionTables& engine) const;
+    void runBatchTick(size_t i);
+    void runSchema();
+
+    const AppConfig& m_cfg;                // stream names and rates only (not reloaded)
+    const ExtractionEngine& m_engine;
+    std::vector<SinkConfig> m_sinks;
+    std::vector<std::unique_ptr<UdpPublisher>> m_publishers;  // one per sink
+    std::vector<std::unique_ptr<Group>> m_groups;
+    std::vector<BatchTick> m_ticks;
+    RateScheduler m_scheduler;           // one entry per batch tick
+    std::thread m_batchThread;
+    std::unique_ptr<Tables> m_current;   // owner of the installed tables
+    std::atomic<Tables*> m_tables{nullptr};
+    std::vector<std::unique_ptr<Tables>> m_retired;
+    RcuDomain::Reader* m_batchReader{nullptr};
+    RcuDomain::Reader* m_schemaReader{nullptr};
+    std::atomic<bool> m_schemaChanged{false};
+    std::string m_payload;               // immediate scratch
+    LatencyStats::Shard* m_latency{nullptr};
+    std::vector<uint64_t> m_pendingCaptures;  // capture times of messages published since the last flush
+    bool m_hasImmediate{false};
+    bool m_hasBinary{false};
+    std::atomic<bool> m_running{false};
+    std::thread m_schemaThread;
+};
+
+} // namespace ddc
@@ -0,0 +1,12 @@
+#pragma once
+
+namespace ddc {
+
+// What a producer does when the ring is full
+enum class OverflowPolicy {
+    Block,      // wait for the consumer (lossless, may stall the producer)
+    DropNewest, // discard the item being pushed
+    DropOldest, // discard the oldest queued item to make room
+};
+
+} // namespace ddc
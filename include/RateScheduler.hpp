@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace ddc {
+
+// Runs periodic entries of different rates from one thread. Tick k of an entry is due at
+// start + k * period (computed, not accumulated), picked from a min-heap of deadlines and
+// waited for with sleep_until, so rates do not drift. A tick that is late is still served
+// and its lateness recorded; ticks whose slot passed entirely before the previous one
+// finished are skipped and counted as missed rather than sent in a burst.
+class RateScheduler {
+public:
+    struct Stats {
+        uint64_t ticks{0};
+        uint64_t missed{0};
+        double meanLatenessUs{0.0};   // wake-up after the deadline (jitter)
+        double maxLatenessUs{0.0};
+    };
+
+    // Returns the entry index passed to onTick.
+    size_t add(double rateHz);
+    size_t size() const { return m_entries.size(); }
+
+    // Calls onTick(entry) at every deadline until `running` goes false; the first tick of
+    // every entry is due immediately.
+    void run(const std::function<void(size_t)>& onTick, const std::atomic<bool>& running);
+
+    // Read after run() has returned.
+    Stats stats(size_t entry) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    struct Entry {
+        std::chrono::duration<double> period;
+        uint64_t tick{0};             // index of the next deadline
+        uint64_t served{0};
+        uint64_t missed{0};
+        double latenessSumUs{0.0};
+        double latenessMaxUs{0.0};
+    };
+
+    Clock::time_point deadline(const Entry& e) const {
+        return m_start + std::chrono::duration_cast<Clock::duration>(e.period * static_cast<double>(e.tick));
+    }
+
+    std::vector<Entry> m_entries;
+    Clock::time_point m_start{};
+};
+
+} // namespace ddc
@@ -0,0 +1,60 @@
+#pragma once
+#include "B1553Monitor.hpp"
+#include "RawRecording.hpp"
+#include "SpscRing.hpp"
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ddc {
+
+// Appends raw messages to a recording (format in RawRecording.hpp). record() copies the
+// message onto a ring; a writer thread encodes records into large blocks and writes them,
+// inserting an index record every kIndexIntervalUs of bus time or kIndexIntervalMessages.
+class RawRecorder {
+public:
+    static constexpr size_t kQueueCapacity = 65536;
+    static constexpr size_t kBlockBytes = 1 << 20;
+    static constexpr uint64_t kIndexIntervalUs = 1000000;
+    static constexpr uint64_t kIndexIntervalMessages = 65536;
+
+    RawRecorder();
+    ~RawRecorder();
+
+    bool open(const std::string& path, std::string& err);
+    // Single producer (the capture callback). Blocks only if the writer falls a full ring behind.
+    void record(const Raw1553Message& msg) { m_ring.push(msg); }
+    // Drains the ring, writes the trailer and closes the file.
+    void close();
+
+    uint64_t messages() const { return m_messages.load(std::memory_order_relaxed); }
+    uint64_t bytes() const { return m_bytes.load(std::memory_order_relaxed); }
+    uint64_t producerStalls() const { return m_ring.stalls(); }
+    size_t queueHighWater() const { return m_ring.highWaterMark(); }
+
+private:
+    void run();
+    void append(const Raw1553Message& msg);
+    void writeIndex(uint64_t timestamp);
+    void writeBlock();
+
+    std::FILE* m_file{nullptr};
+    SpscRing<Raw1553Message> m_ring;
+    std::thread m_writer;
+    std::atomic<bool> m_stop{false};
+    std::atomic<uint64_t> m_messages{0};
+    std::atomic<uint64_t> m_bytes{0};
+    // Writer thread only
+    std::vector<uint8_t> m_block;
+    uint64_t m_offset{0};           // file offset of m_block[0]
+    uint64_t m_lastIndexOffset{0};
+    uint64_t m_lastIndexTs{0};
+    uint64_t m_lastIndexOrdinal{0};
+    uint32_t m_indexCount{0};
+    uint64_t m_firstTs{0};
+    uint64_t m_lastTs{0};
+};
+
+} // namespace ddc
@@ -0,0 +1,86 @@
+#pragma once
+#include "B1553Monitor.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ddc {
+
+// Raw bus recording (.r1553), append-only, all integers little-endian.
+//
+// File header (32 bytes): "DDC1553R" | u16 version | u16 headerSize | u32 reserved | u64 created_unix_us | u64 reserved
+// Records, each starting with a u8 type:
+//   Message (24 + 2*n bytes): u8 type | u8 flags (bit0 tx, bit1 mode code, bits 2-7 bus) | u8 rt | u8 sa | u8 n (data words)
+//                             | u8 channel | u16 wordCount | u64 timestamp | u32 status1 | u32 status2 | n x u16 data
+//   Index   (32 bytes):       u8 type | 7 pad | u64 timestamp of the next message | u64 messages before it
+//                             | u64 offset of the previous index record (0 = none)
+//   Trailer (48 bytes):       u8 type | 3 pad | u32 indexCount | u64 last index offset | u64 messageCount
+//                             | u64 first timestamp | u64 last timestamp | u64 reserved
+// Index records are written periodically; the trailer (written on close) links to the last
+// one. A file without a trailer (e.g. after a crash) is still readable by scanning.
+constexpr char kRecordingMagic[8] = {'D', 'D', 'C', '1', '5', '5', '3', 'R'};
+constexpr uint16_t kRecordingVersion = 1;
+constexpr size_t kRecordingHeaderSize = 32;
+constexpr size_t kRecordMessageHeaderSize = 24;
+constexpr size_t kRecordIndexSize = 32;
+constexpr size_t kRecordTrailerSize = 48;
+
+enum class RecordType : uint8_t { Message = 1, Index = 2, Trailer = 3 };
+
+struct RecordingIndexEntry {
+    uint64_t timestamp{};   // first message at or after this point
+    uint64_t ordinal{};     // messages before it
+    uint64_t offset{};      // file offset of that message
+};
+
+// Read-only, memory-mapped view of a recording.
+class RawRecordingReader {
+public:
+    RawRecordingReader() = default;
+    ~RawRecordingReader();
+    RawRecordingReader(const RawRecordingReader&) = delete;
+    RawRecordingReader& operator=(const RawRecordingReader&) = delete;
+
+    bool open(const std::string& path, std::string& err);
+    void close();
+
+    // Decodes the message at the cursor and advances; false at the end of the recording.
+    bool next(Raw1553Message& out);
+    // Header of the message at the cursor, without decoding it or advancing; false at the end.
+    struct Peek { uint64_t timestamp; uint16_t rt; uint16_t sa; bool tx; };
+    bool peek(Peek& out);
+    // Steps over the message at the cursor (the one peek() returned).
+    void skip();
+    // Moves the cursor to the first indexed position at or before `timestamp`.
+    void seek(uint64_t timestamp);
+    void rewind() { m_cursor = m_dataStart; }
+
+    uint64_t messageCount() const { return m_messageCount; }
+    uint64_t firstTimestamp() const { return m_firstTs; }
+    uint64_t lastTimestamp() const { return m_lastTs; }
+    bool hasTrailer() const { return m_hasTrailer; }
+    const std::vector<RecordingIndexEntry>& index() const { return m_index; }
+
+private:
+    bool scan();                    // rebuild index and totals when there is no usable trailer
+    const uint8_t* message();       // message record at the cursor (past index records), or null
+    bool loadTrailer();
+
+    const uint8_t* m_data{nullptr};
+    size_t m_size{0};
+    size_t m_dataStart{kRecordingHeaderSize};
+    size_t m_dataEnd{0};            // start of the trailer, or end of the last complete record
+    size_t m_cursor{0};
+    uint64_t m_messageCount{0};
+    uint64_t m_firstTs{0};
+    uint64_t m_lastTs{0};
+    bool m_hasTrailer{false};
+    std::vector<RecordingIndexEntry> m_index;
+#ifdef _WIN32
+    void* m_file{nullptr};
+    void* m_mapping{nullptr};
+#endif
+};
+
+} // namespace ddc
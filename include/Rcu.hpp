@@ -0,0 +1,51 @@
+#pragma once
+#include "Atomics.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ddc {
+
+// Quiescent-state-based RCU for tables that hot-path threads read without locks. A writer
+// publishes a new table pointer, then synchronize() waits until every registered reader
+// has passed a quiescent state (a point where it holds no table pointer) or is offline;
+// after that the old tables can be freed. Readers never wait: quiescent() is one load and
+// one store. A reader that sleeps between uses goes offline() and comes back online()
+// before its next pointer load.
+class RcuDomain {
+public:
+    class alignas(kCacheLine) Reader {
+    public:
+        // Between uses; the thread must not keep pointers loaded before this call
+        void quiescent() {
+            m_seen.store(m_domain->m_epoch.load(std::memory_order_acquire), std::memory_order_release);
+        }
+        void offline() { m_seen.store(kOffline, std::memory_order_release); }
+        void online() {
+            m_seen.store(m_domain->m_epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+            // Either synchronize() sees us online, or our next pointer load sees its update
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+    private:
+        friend class RcuDomain;
+        static constexpr uint64_t kOffline = ~0ull;
+        const RcuDomain* m_domain{nullptr};
+        std::atomic<uint64_t> m_seen{kOffline};
+    };
+
+    // Registered offline; valid for the domain's lifetime. Any thread.
+    Reader* addReader();
+    // Writer side, after publishing the new pointer: returns once no reader can still hold
+    // the old one. Sleeps; one writer at a time.
+    void synchronize();
+
+private:
+    std::atomic<uint64_t> m_epoch{1};
+    std::mutex m_mtx;     // registry only
+    std::vector<std::unique_ptr<Reader>> m_readers;
+};
+
+} // namespace ddc
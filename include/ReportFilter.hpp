@@ -0,0 +1,53 @@
+#pragma once
+#include "Config.hpp"
+#include "ExtractionPlan.hpp"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace ddc {
+
+// Per-field exception reporting. A value is due when its field has no report settings,
+// when it is the field's first, or when at least min_interval_ms has passed since the
+// last reported value and it either differs from that value by more than the deadband
+// or max_interval_ms has passed. Comparing against the last *reported* value means slow
+// drift is still reported once it adds up. Intervals use the message timestamps, so
+// replay filters exactly as live capture did. apply() runs on one thread.
+class ReportFilter {
+public:
+    explicit ReportFilter(const std::vector<FieldSpec>& fields);
+
+    // Config reload (field ids kept by name, see ExtractionPlan): takes the new settings and
+    // keeps each field's last reported value. Same thread as apply().
+    void update(const std::vector<FieldSpec>& fields);
+
+    // Any field with report settings; otherwise apply() passes everything through.
+    bool active() const { return m_active; }
+    // Copies the due values to `out` (may equal `in`) and returns their count.
+    size_t apply(const FieldValue* in, size_t count, FieldValue* out);
+
+    // Any thread
+    uint64_t passed() const { return m_passed.load(std::memory_order_relaxed); }
+    uint64_t suppressed() const { return m_suppressed.load(std::memory_order_relaxed); }
+
+private:
+    struct Field {
+        bool enabled{false};
+        bool reported{false};
+        double deadband{0.0};
+        double deadbandFraction{0.0};
+        uint64_t minUs{0};
+        uint64_t maxUs{0};
+        double last{0.0};
+        uint64_t lastTs{0};
+    };
+
+    bool due(const FieldValue& v);
+
+    std::vector<Field> m_fields;     // by field id
+    bool m_active{false};
+    std::atomic<uint64_t> m_passed{0};       // single writer
+    std::atomic<uint64_t> m_suppressed{0};
+};
+
+} // namespace ddc
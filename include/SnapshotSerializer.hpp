@@ -0,0 +1,47 @@
+#pragma once
+#include "JsonFormatter.hpp"
+#include "LatestValueStore.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ddc {
+
+// Batch-mode JSON encoder compiled once from the config's dotted field names.
+// The nesting structure, escaped keys and braces are precomputed in nlohmann's
+// (sorted) key order; each tick only formats numbers into a reusable buffer.
+// Output is byte-identical to ExtractionEngine::buildJsonSnapshot() plus "seq".
+class SnapshotSerializer {
+public:
+    // fieldNames: every field name indexed by field id.
+    // fieldIds: fields to include (empty = all).
+    SnapshotSerializer(const std::vector<std::string>& fieldNames,
+                       const std::vector<uint32_t>& fieldIds = {});
+
+    // Encode fields that are valid in `snap`. Not thread-safe: one caller per instance.
+    void serialize(const ValueSnapshot& snap, uint64_t seq, std::string& out);
+
+private:
+    enum class Kind : uint8_t { Object, Field, TimestampUs, Timestamp, Datetime, Seq };
+
+    // Preorder-flattened key tree
+    struct Node {
+        std::string key;        // escaped, quoted key plus ':'
+        Kind kind{Kind::Object};
+        uint32_t parent{};      // kNoParent for top-level nodes
+        uint32_t end{};         // one past the last node of this subtree
+        uint32_t firstId{};     // Field: range into m_leafIds
+        uint32_t idCount{};
+    };
+    static constexpr uint32_t kNoParent = 0xFFFFFFFFu;
+
+    void emit(uint32_t first, uint32_t end, const ValueSnapshot& snap, uint64_t seq,
+              uint64_t latestTs, std::string& out);
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_leafIds; // field ids per leaf, ascending (last valid one wins)
+    std::vector<uint8_t> m_present;  // per-tick scratch
+    IsoSecondClock m_clock;
+};
+
+} // namespace ddc
@@ -0,0 +1,142 @@
+#pragma once
+#include "Atomics.hpp"
+#include "OverflowPolicy.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ddc {
+
+// Bounded single-producer/single-consumer ring. Exactly one thread may call push()
+// and exactly one thread may call pop(). Head and tail live on separate cache lines
+// and each side keeps a cached copy of the other's index so the common case touches
+// no shared line.
+template <typename T>
+class SpscRing {
+    // DropOldest lets the producer reclaim a slot the consumer may be copying; the
+    // consumer detects this and discards its copy, which is only sound for plain data.
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing requires a trivially copyable type");
+
+public:
+    // Largest power of two a size_t holds
+    static constexpr size_t kMaxCapacity = (std::numeric_limits<size_t>::max() >> 1) + 1;
+
+    // Capacity is rounded up to a power of two (clamped to kMaxCapacity).
+    explicit SpscRing(size_t capacity, OverflowPolicy policy = OverflowPolicy::Block)
+        : m_policy(policy) {
+        size_t cap = 2;
+        while (cap < capacity && cap < kMaxCapacity) cap <<= 1;
+        m_mask = cap - 1;
+        m_slots.resize(cap);
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer side. Returns false if the item was not queued (DropNewest on a
+    // full ring, or Block after close()).
+    bool push(const T& item) {
+        size_t t = m_tail.load(std::memory_order_relaxed);
+        // Refresh the consumer index when the ring looks full, and periodically so the
+        // high-water mark tracks the real depth rather than a stale cached head.
+        if (t - m_cachedHead > m_mask || (t & kDepthSampleMask) == 0) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (t - m_cachedHead > m_mask && !makeRoom(t)) return false;
+            size_t depth = t + 1 - m_cachedHead;
+            if (depth > m_highWater.load(std::memory_order_relaxed))
+                m_highWater.store(depth, std::memory_order_relaxed);
+        }
+        m_slots[t & m_mask] = item;
+        m_tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false if the ring is empty.
+    bool pop(T& out) {
+        for (;;) {
+            size_t h = m_head.load(std::memory_order_acquire);
+            // >= rather than ==: under DropOldest the producer can move head past our cached tail
+            if (h >= m_cachedTail) {
+                m_cachedTail = m_tail.load(std::memory_order_acquire);
+                if (h >= m_cachedTail) return false;
+            }
+            out = m_slots[h & m_mask];
+            if (m_policy != OverflowPolicy::DropOldest) {
+                m_head.store(h + 1, std::memory_order_release);
+                return true;
+            }
+            // The producer may have dropped this slot while we copied it; retry if so.
+            if (m_head.compare_exchange_strong(h, h + 1, std::memory_order_acq_rel)) return true;
+        }
+    }
+
+    // Wakes a producer blocked in push(); later Block-mode pushes on a full ring fail.
+    void close() { m_closed.store(true, std::memory_order_release); }
+
+    size_t capacity() const { return m_mask + 1; }
+    // Any thread. Head is read first so a concurrent pop cannot make the result negative.
+    size_t size() const {
+        size_t h = m_head.load(std::memory_order_acquire);
+        return m_tail.load(std::memory_order_acquire) - h;
+    }
+    OverflowPolicy policy() const { return m_policy; }
+    // Items discarded by DropNewest/DropOldest
+    uint64_t overruns() const { return m_overruns.load(std::memory_order_relaxed); }
+    // Pushes that found the ring full and had to wait (Block)
+    uint64_t stalls() const { return m_stalls.load(std::memory_order_relaxed); }
+    // Deepest fill level seen by the producer (sampled every 64 pushes and whenever full)
+    size_t highWaterMark() const { return m_highWater.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t kDepthSampleMask = 63;
+
+    // Full ring: apply the overflow policy. Returns true once slot `t` may be written.
+    bool makeRoom(size_t t) {
+        switch (m_policy) {
+        case OverflowPolicy::DropNewest:
+            m_overruns.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        case OverflowPolicy::DropOldest:
+            for (;;) {
+                size_t h = m_cachedHead;
+                if (m_head.compare_exchange_strong(h, h + 1, std::memory_order_acq_rel)) {
+                    m_overruns.fetch_add(1, std::memory_order_relaxed);
+                    m_cachedHead = h + 1;
+                    return true;
+                }
+                m_cachedHead = h; // consumer advanced; there may be room now
+                if (t - m_cachedHead <= m_mask) return true;
+            }
+        case OverflowPolicy::Block:
+        default:
+            m_stalls.fetch_add(1, std::memory_order_relaxed);
+            while (t - m_cachedHead > m_mask) {
+                if (m_closed.load(std::memory_order_acquire)) return false;
+                std::this_thread::yield();
+                m_cachedHead = m_head.load(std::memory_order_acquire);
+            }
+            return true;
+        }
+    }
+
+    OverflowPolicy m_policy;
+    size_t m_mask{0};
+    std::vector<T> m_slots;
+
+    alignas(kCacheLine) std::atomic<size_t> m_head{0}; // next slot to read
+    size_t m_cachedTail{0};                             // consumer's view of m_tail
+
+    alignas(kCacheLine) std::atomic<size_t> m_tail{0}; // next slot to write
+    size_t m_cachedHead{0};                             // producer's view of m_head
+
+    alignas(kCacheLine) std::atomic<uint64_t> m_overruns{0};
+    std::atomic<uint64_t> m_stalls{0};
+    std::atomic<size_t> m_highWater{0};
+    std::atomic<bool> m_closed{false};
+};
+
+} // namespace ddc
@@ -0,0 +1,62 @@
+#pragma once
+#include "BusAnalyzer.hpp"
+#include "LatencyStats.hpp"
+#include "Metrics.hpp"
+#include "UdpPublisher.hpp"
+#include <nlohmann/json_fwd.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ddc {
+
+// Periodic runtime stats as JSON datagrams on their own port: pipeline counters (totals and
+// per-second rates since the previous report), latency percentiles, per-key message and
+// bounds-miss counts, and whatever the application adds through `extra` (queues, sinks,
+// CSV). Keys with traffic go in separate "key_stats" datagrams of up to kKeysPerDatagram
+// entries so a report never exceeds a UDP datagram; with a BusAnalyzer, its per-key schedule
+// statistics follow as "bus_stats" datagrams.
+class StatsReporter {
+public:
+    using Extra = std::function<void(nlohmann::json& report)>;
+    static constexpr size_t kKeysPerDatagram = 256;
+    static constexpr size_t kBusKeysPerDatagram = 64;
+
+    StatsReporter(const Metrics& metrics, const LatencyStats* latency);
+    ~StatsReporter();
+
+    bool open(const std::string& host, uint16_t port, std::string& err);
+    // Before start()
+    void setBusAnalyzer(const BusAnalyzer* analyzer) { m_bus = analyzer; }
+    void start(int intervalMs, Extra extra = {});
+    void stop();
+
+    // One report: datagrams[0] is the "stats" object, the rest "key_stats". Reporter thread
+    // (or before start()).
+    void build(std::vector<std::string>& datagrams, const Extra& extra);
+    uint64_t reports() const { return m_reports.load(std::memory_order_relaxed); }
+
+private:
+    void run(int intervalMs, Extra extra);
+    void buildBusStats(uint64_t seq, std::vector<std::string>& datagrams);
+
+    const Metrics& m_metrics;
+    const LatencyStats* m_latency;
+    UdpPublisher m_udp;
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<uint64_t> m_reports{0};
+    const std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_lastReport;
+    std::array<uint64_t, kCounterCount> m_lastTotals{};
+    std::vector<Metrics::KeyTotals> m_keys;
+    const BusAnalyzer* m_bus{nullptr};
+    std::vector<BusAnalyzer::KeyStats> m_busKeys;
+    std::vector<BusAnalyzer::KeyStats> m_lastBusKeys;   // previous report, for interval rates
+};
+
+} // namespace ddc
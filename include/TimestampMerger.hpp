@@ -0,0 +1,60 @@
+#pragma once
+#include "B1553Monitor.hpp"
+#include "SpscRing.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ddc {
+
+// Merges per-device capture rings into one timestamp-ordered stream. Each source is in
+// order on its own and publishes the timestamp of its latest push, so the oldest pending
+// message is safe to release once every other source is either holding something or has
+// already pushed past it. A quiet source would stall that, so a message is also released
+// when it is `windowUs` older than the newest push on any source, or when nothing new has
+// been pushed for `windowUs` of wall time. Messages arriving later than that are passed on
+// out of order and counted. Single consumer; one producer per source.
+class TimestampMerger {
+public:
+    TimestampMerger(size_t sources, size_t capacity, OverflowPolicy policy, uint64_t windowUs);
+
+    size_t sourceCount() const { return m_sources.size(); }
+    // Producer side of source i (its capture thread only)
+    bool push(size_t i, const Raw1553Message& msg) {
+        Source& s = m_sources[i];
+        if (!s.ring->push(msg)) return false;
+        s.latest.store(msg.timestamp, std::memory_order_release);
+        return true;
+    }
+    const SpscRing<Raw1553Message>& input(size_t i) const { return *m_sources[i].ring; }
+
+    // Next message in timestamp order; false if nothing is due yet.
+    bool pop(Raw1553Message& out) { return next(out, false); }
+    // Same, ignoring the window (producers have stopped).
+    bool drain(Raw1553Message& out) { return next(out, true); }
+
+    // Messages released after a younger one from another source
+    uint64_t outOfOrder() const { return m_outOfOrder; }
+
+private:
+    struct Source {
+        std::unique_ptr<SpscRing<Raw1553Message>> ring;
+        std::atomic<uint64_t> latest{0};                // timestamp of the last push
+        uint64_t seen{0};                               // consumer's read of latest, before its pop
+        Raw1553Message head;
+        bool hasHead{false};
+    };
+
+    bool next(Raw1553Message& out, bool force);
+
+    std::vector<Source> m_sources;
+    uint64_t m_windowUs;
+    uint64_t m_lastOutTs{0};
+    uint64_t m_outOfOrder{0};
+    uint64_t m_blockedNewest{~0ull};                    // newest push when we last had to wait
+    std::chrono::steady_clock::time_point m_blockedSince{};
+};
+
+} // namespace ddc
@@ -1,31 +1,71 @@
 #pragma once
 #include <string>
 #include <cstdint>
+#include <vector>
+#ifdef _WIN32
 #ifndef _WIN32_WINNT
 #define _WIN32_WINNT 0x0600
 #endif
 #include <winsock2.h>
 #include <ws2tcpip.h>
-#include <mutex>
-
 #pragma comment(lib, "ws2_32.lib")
+#else
+#include <netinet/in.h>
+#endif
+#include <mutex>
 
 namespace ddc {
 
+struct UdpStats {
+    uint64_t datagrams{0};  // handed to the kernel
+    uint64_t bytes{0};
+    uint64_t syscalls{0};   // send calls that transmitted at least one datagram
+    uint64_t sendErrors{0}; // failed send calls (other than would-block)
+    uint64_t wouldBlock{0}; // EAGAIN / EWOULDBLOCK occurrences
+    uint64_t dropped{0};    // datagrams discarded after an error
+};
+
+struct UdpOptions {
+    int sendBufferBytes{0};         // SO_SNDBUF; 0 keeps the OS default
+    int multicastTtl{1};            // IPv4 multicast destinations only
+    std::string multicastInterface; // local IPv4 address for outgoing multicast; empty = OS default
+};
+
+// UDP sender. send() transmits immediately; enqueue() buffers datagrams and
+// flush() hands them to the kernel in as few syscalls as possible (sendmmsg and,
+// where supported, UDP GSO on Linux). All methods are thread-safe.
 class UdpPublisher {
 public:
+    static constexpr size_t kMaxBatch = 64;        // datagrams queued before an automatic flush
+
     UdpPublisher();
     ~UdpPublisher();
 
-    bool open(const std::string& host, uint16_t port);
+    bool open(const std::string& host, uint16_t port, const UdpOptions& options = {});
     bool send(const std::string& payload);
+    bool enqueue(const std::string& payload);
+    void flush();
     void close();
 
+    UdpStats stats() const;
+
 private:
+    void flushLocked();
+    bool applyOptions(const UdpOptions& options);
+    bool sendOne(const char* data, size_t size);
+
+#ifdef _WIN32
     SOCKET m_sock{INVALID_SOCKET};
-    sockaddr_in m_addr{};
-    std::mutex m_mtx;
     bool m_initialized{false};
+#else
+    int m_sock{-1};
+    bool m_gso{false};                  // kernel accepts UDP_SEGMENT
+#endif
+    sockaddr_in m_addr{};
+    mutable std::mutex m_mtx;
+    std::vector<char> m_queue;          // queued payloads, back to back
+    std::vector<uint32_t> m_queueEnd;   // end offset of each queued payload
+    UdpStats m_stats;
 };
 
 } // namespace ddc
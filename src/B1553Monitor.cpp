@@ -1,14 +1,20 @@
 #include "B1553Monitor.hpp"
+#include "AcceptanceMask.hpp"
+#include "BusSimulator.hpp"
+#include "LatencyStats.hpp"
+#include "RawRecording.hpp"
+#include <algorithm>
 #include <chrono>
 #include <thread>
-#include <random>
 
 // TODO: Replace placeholders with actual DDC aceXtreme API calls.
 // This skeleton simulates message reception until integrated with hardware.
 
 namespace ddc {
 
-B1553Monitor::B1553Monitor() = default;
+B1553Monitor::B1553Monitor() {
+    for (auto& w : m_accept) w.store(~0ull, std::memory_order_relaxed);
+}
 B1553Monitor::~B1553Monitor() { stop(); }
 
 bool B1553Monitor::open(const std::string& deviceName, uint32_t channelMask) {
@@ -22,10 +28,28 @@ bool B1553Monitor::start(MessageCallback cb) {
     if (m_running.load()) return false;
     m_callback = std::move(cb);
     m_running = true;
-    m_thread = std::thread(&B1553Monitor::monitorLoop, this);
+    m_finished = false;
+    m_simLateFrames = 0;
+    if (m_replay) m_thread = std::thread(&B1553Monitor::replayLoop, this);
+    else if (m_sim) m_thread = std::thread(&B1553Monitor::simulationLoop, this);
+    else m_thread = std::thread(&B1553Monitor::monitorLoop, this);
     return true;
 }
 
+void B1553Monitor::setAcceptance(const AcceptanceMask& mask) {
+    static_assert(AcceptanceMask::kWords == 32, "one mask word per RT");
+    for (size_t rt = 0; rt < AcceptanceMask::kWords; ++rt)
+        m_accept[rt].store(mask.words()[rt], std::memory_order_relaxed);
+    // TODO: With the SDK, program the monitor's RT/SA filter from mask.subaddressMask(rt, tx)
+    // per RT and direction, so filtered traffic never reaches the host at all.
+}
+
+AcceptanceMask B1553Monitor::acceptance() const {
+    std::array<uint64_t, AcceptanceMask::kWords> words;
+    for (size_t rt = 0; rt < words.size(); ++rt) words[rt] = m_accept[rt].load(std::memory_order_relaxed);
+    return AcceptanceMask::fromWords(words);
+}
+
 void B1553Monitor::stop() {
     if (!m_running.load()) return;
     m_running = false;
@@ -36,64 +60,97 @@ void B1553Monitor::stop() {
 
 void B1553Monitor::monitorLoop() {
     using namespace std::chrono_literals;
-    auto start = std::chrono::steady_clock::now();
-    std::mt19937 rng{std::random_device{}()};
-    std::uniform_int_distribution<uint16_t> wordDist(0, 0xFFFF);
-    static uint16_t incBase = 0;
-    std::uniform_int_distribution<int> boolDist(0,1);
-    size_t rtIdx = 0, saIdx = 0;
-    auto simInterval = std::chrono::duration<double>(m_simIntervalSec);
+    auto start = (m_timeBase == std::chrono::steady_clock::time_point{}) ? std::chrono::steady_clock::now() : m_timeBase;
     while (m_running.load()) {
+        // Placeholder hardware fetch: the command word is read first, and the rest of the
+        // message only for accepted keys
+        const uint16_t rt = 1, sa = 2;
+        const bool tx = false;
+        if (!accept(rt, sa, tx)) { std::this_thread::sleep_for(200ms); continue; }
         Raw1553Message msg;
-        if (m_simulation) {
-            if (m_simRTs.empty()) m_simRTs = {5};
-            if (m_simSAs.empty()) m_simSAs = {17,22};
-            msg.rtAddress = m_simRTs[rtIdx++ % m_simRTs.size()];
-            msg.subAddress = m_simSAs[saIdx++ % m_simSAs.size()];
-            // Previously was random (boolDist). This caused half the simulated messages
-            // to have tx=true while config fields (e.g. "17R" / "22R") expect receive (tx=false).
-            // That mismatch meant no extraction early on, giving the impression of no data.
-            // For deterministic simulation aligned with typical monitor direction, force tx=false.
-            msg.tx = false; // simulate receive (R) direction consistently
-            msg.wordCount = m_simWC;
-            msg.isModeCode = false;
-            msg.channel = 0;
-            msg.dataWords.resize(m_simWC);
-            for (auto &w : msg.dataWords) {
-                if (m_simPatternRandom) {
-                    w = wordDist(rng);
-                } else {
-                    w = incBase++;
-                }
-            }
-        } else {
-            // Placeholder hardware fetch
-            msg.rtAddress = 1; msg.tx=false; msg.subAddress=2; msg.wordCount=4; msg.isModeCode=false; msg.channel=0;
-            msg.dataWords = {0x1111,0x2222,0x3333,0x4444};
-        }
+        msg.rtAddress = rt; msg.tx = tx; msg.subAddress = sa; msg.wordCount=4; msg.isModeCode=false; msg.channel=0;
+        msg.dataWords[0] = 0x1111; msg.dataWords[1] = 0x2222; msg.dataWords[2] = 0x3333; msg.dataWords[3] = 0x4444;
+        msg.dataWordCount = 4;
+        msg.bus = m_bus;
         auto now = std::chrono::steady_clock::now();
         auto us = std::chrono::duration_cast<std::chrono::microseconds>(now - start).count();
         msg.timestamp = static_cast<uint64_t>(us);
         msg.statusWord1 = 0; msg.statusWord2 = 0;
+        msg.hostTimeNs = steadyNowNs();
         if (m_callback) m_callback(msg);
-        if (m_simulation) {
-            std::this_thread::sleep_for(simInterval);
-        } else {
-            std::this_thread::sleep_for(200ms);
-        }
+        std::this_thread::sleep_for(200ms);
+    }
+}
+
+// Sleeps in short slices so stop() isn't held up by a long wait; false if stopped meanwhile.
+bool B1553Monitor::waitUntil(std::chrono::steady_clock::time_point due) const {
+    for (auto now = std::chrono::steady_clock::now(); due > now && m_running.load();
+         now = std::chrono::steady_clock::now())
+        std::this_thread::sleep_until(std::min(due, now + std::chrono::milliseconds(50)));
+    return m_running.load();
+}
+
+// One minor frame per absolute deadline, sent as a burst. A late frame is sent at once
+// (no sleep) so the average rate holds even when single sleeps overshoot.
+void B1553Monitor::simulationLoop() {
+    std::vector<Raw1553Message> frame;
+    frame.reserve(static_cast<size_t>(m_sim->messagesPerSecond() / m_sim->minorFrameHz()) + 16);
+    const std::chrono::duration<double> period(1.0 / m_sim->minorFrameHz());
+    const auto start = std::chrono::steady_clock::now();
+    // Bus time starts at 0 on our first frame; shift it onto the shared time base
+    const uint64_t offsetUs = (m_timeBase == std::chrono::steady_clock::time_point{} || start < m_timeBase) ? 0
+        : static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(start - m_timeBase).count());
+    for (uint64_t n = 0;; ++n) {
+        auto due = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(period * static_cast<double>(n));
+        auto now = std::chrono::steady_clock::now();
+        if (due > now) { if (!waitUntil(due)) break; }
+        else if (now - due > period) ++m_simLateFrames;
+        if (!m_running.load()) break;
+        frame.clear();
+        const AcceptanceMask mask = acceptance();
+        const uint64_t scheduled = m_sim->messages();
+        m_sim->nextFrame(frame, &mask);       // filtered messages are never built
+        count(frame.size(), m_sim->messages() - scheduled - frame.size());
+        const uint64_t hostNs = steadyNowNs();
+        for (auto& msg : frame) { msg.timestamp += offsetUs; msg.bus = m_bus; msg.hostTimeNs = hostNs; }
+        if (m_callback) for (const auto& msg : frame) m_callback(msg);
     }
 }
 
-void B1553Monitor::enableSimulation(double rateHz, const std::vector<uint16_t>& rts,
-                          const std::vector<uint16_t>& subAddresses,
-                          uint16_t wordCount,
-                          bool randomPattern) {
-    m_simulation = true;
-    m_simIntervalSec = (rateHz > 0) ? 1.0 / rateHz : 0.02;
-    m_simRTs = rts;
-    m_simSAs = subAddresses;
-    m_simWC = wordCount;
-    m_simPatternRandom = randomPattern;
+// Paces against the wall clock from the first recorded timestamp, so a slow callback
+// delays later messages rather than accumulating drift.
+// Filtered records are stepped over from their header, without decoding the data words.
+void B1553Monitor::replayLoop() {
+    Raw1553Message msg;
+    RawRecordingReader::Peek head;
+    if (!m_replay->peek(head)) { m_finished = true; return; }
+    const uint64_t firstTs = head.timestamp;
+    const auto start = std::chrono::steady_clock::now();
+    do {
+        if (!accept(head.rt, head.sa, head.tx)) { m_replay->skip(); continue; }
+        if (m_replaySpeed > 0 && head.timestamp > firstTs) {
+            auto offset = std::chrono::duration<double, std::micro>((head.timestamp - firstTs) / m_replaySpeed);
+            auto due = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset);
+            if (!waitUntil(due)) break;
+        }
+        if (!m_replay->next(msg)) break;
+        msg.hostTimeNs = steadyNowNs();
+        if (m_callback) m_callback(msg);
+    } while (m_running.load() && m_replay->peek(head));
+    m_finished = true;
+}
+
+bool B1553Monitor::enableReplay(const std::string& path, double speed, std::string& err) {
+    if (speed < 0) { err = "replay speed must be >= 0"; return false; }
+    auto reader = std::make_unique<RawRecordingReader>();
+    if (!reader->open(path, err)) return false;
+    m_replay = std::move(reader);
+    m_replaySpeed = speed;
+    return true;
+}
+
+void B1553Monitor::enableSimulation(const AppConfig& cfg) {
+    m_sim = std::make_unique<BusSimulator>(cfg);
 }
 
 } // namespace ddc
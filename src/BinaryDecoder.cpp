@@ -0,0 +1,97 @@
+#include "BinaryDecoder.hpp"
+
+namespace ddc {
+
+BinaryDecoder::Result BinaryDecoder::feed(const uint8_t* data, size_t size, DecodedFrame& out) {
+    if (size < kBinaryHeaderSize || getLE(data, 4) != kBinaryMagic || data[4] != kBinaryVersion)
+        return Result::Invalid;
+    uint32_t schemaId = static_cast<uint32_t>(getLE(data + 8, 4));
+    switch (static_cast<BinaryKind>(data[5])) {
+    case BinaryKind::Schema: return feedSchema(data, size, schemaId);
+    case BinaryKind::Data:
+        if (!m_complete || schemaId != m_schemaId) return Result::NeedSchema;
+        return feedData(data, size, schemaId, out);
+    }
+    return Result::Invalid;
+}
+
+BinaryDecoder::Result BinaryDecoder::feedSchema(const uint8_t* p, size_t size, uint32_t schemaId) {
+    if (size < kBinarySchemaHeaderSize) return Result::Invalid;
+    const uint8_t* h = p + kBinaryHeaderSize;
+    size_t fragment = getLE(h, 2);
+    size_t fragmentCount = getLE(h + 2, 2);
+    size_t fieldCount = getLE(h + 4, 4);
+    size_t firstField = getLE(h + 8, 4);
+    size_t entryCount = getLE(h + 12, 2);
+    if (fragment >= fragmentCount || firstField + entryCount > fieldCount) return Result::Invalid;
+
+    if (schemaId != m_schemaId || m_names.size() != fieldCount || m_fragmentSeen.size() != fragmentCount) {
+        // New schema: start collecting from scratch
+        m_schemaId = schemaId;
+        m_complete = false;
+        m_names.assign(fieldCount, std::string());
+        m_types.assign(fieldCount, WireType::F64);
+        m_fragmentSeen.assign(fragmentCount, 0);
+        m_fragmentsMissing = fragmentCount;
+    }
+    if (m_fragmentSeen[fragment]) return Result::Schema;
+
+    const uint8_t* cur = p + kBinarySchemaHeaderSize;
+    const uint8_t* end = p + size;
+    for (size_t i = 0; i < entryCount; ++i) {
+        if (end - cur < 3) return Result::Invalid;
+        WireType t;
+        if (!wireTypeFromByte(cur[0], t)) return Result::Invalid;
+        size_t nameLen = getLE(cur + 1, 2);
+        cur += 3;
+        if (static_cast<size_t>(end - cur) < nameLen) return Result::Invalid;
+        m_types[firstField + i] = t;
+        m_names[firstField + i].assign(reinterpret_cast<const char*>(cur), nameLen);
+        cur += nameLen;
+    }
+    m_fragmentSeen[fragment] = 1;
+    if (--m_fragmentsMissing == 0) m_complete = true;
+    return Result::Schema;
+}
+
+BinaryDecoder::Result BinaryDecoder::feedData(const uint8_t* p, size_t size, uint32_t schemaId,
+                                              DecodedFrame& out) const {
+    if (size < kBinaryDataHeaderSize) return Result::Invalid;
+    size_t firstField = getLE(p + kBinaryHeaderSize, 4);
+    size_t bitmapBytes = getLE(p + kBinaryHeaderSize + 4, 2);
+    if (size < kBinaryDataHeaderSize + bitmapBytes) return Result::Invalid;
+    out.schemaId = schemaId;
+    out.seq = getLE(p + 12, 8);
+    out.timestampUs = getLE(p + 20, 8);
+    out.values.clear();
+    const uint8_t* bitmap = p + kBinaryDataHeaderSize;
+    const uint8_t* cur = bitmap + bitmapBytes;
+    const uint8_t* end = p + size;
+    for (size_t bit = 0; bit < bitmapBytes * 8; ++bit) {
+        if (!(bitmap[bit >> 3] & (1u << (bit & 7)))) continue;
+        size_t id = firstField + bit;
+        if (id >= m_types.size()) return Result::Invalid;
+        WireType t = m_types[id];
+        size_t width = wireTypeSize(t);
+        if (static_cast<size_t>(end - cur) < width) return Result::Invalid;
+        uint64_t raw = getLE(cur, width);
+        cur += width;
+        double v = 0;
+        switch (t) {
+        case WireType::U8:
+        case WireType::U32: v = static_cast<double>(raw); break;
+        case WireType::I32: v = static_cast<double>(static_cast<int32_t>(static_cast<uint32_t>(raw))); break;
+        case WireType::F32: {
+            uint32_t bits = static_cast<uint32_t>(raw);
+            float f; std::memcpy(&f, &bits, sizeof(f));
+            v = static_cast<double>(f);
+            break;
+        }
+        case WireType::F64: std::memcpy(&v, &raw, sizeof(v)); break;
+        }
+        out.values.push_back(DecodedValue{static_cast<uint32_t>(id), v});
+    }
+    return Result::Data;
+}
+
+} // namespace ddc
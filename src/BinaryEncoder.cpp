@@ -0,0 +1,175 @@
+#include "BinaryEncoder.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ddc {
+
+namespace {
+
+bool isPowerOfTwo(double scale) {
+    int exp = 0;
+    return scale > 0 && std::isfinite(scale) && std::frexp(scale, &exp) == 0.5;
+}
+
+template <typename T>
+T saturate(double v) {
+    if (!(v == v)) return 0; // NaN
+    double r = std::nearbyint(v);
+    if (r <= static_cast<double>(std::numeric_limits<T>::min())) return std::numeric_limits<T>::min();
+    if (r >= static_cast<double>(std::numeric_limits<T>::max())) return std::numeric_limits<T>::max();
+    return static_cast<T>(r);
+}
+
+} // namespace
+
+WireType defaultWireType(const FieldSpec& f) {
+    WireType t;
+    if (!f.wireType.empty() && parseWireType(f.wireType, t)) return t;
+    if (f.aggregate == Aggregate::Count) return WireType::U32;
+    if (f.aggregate == Aggregate::Mean || f.aggregate == Aggregate::Rms) return WireType::F64;
+    bool valid = false;
+    DecodeOp op = ExtractionPlan::compile(f, 0, valid);
+    if (!valid) return WireType::F64;
+    bool unscaled = op.scale == 1.0;
+    bool pow2 = isPowerOfTwo(op.scale);
+    switch (op.op) {
+    case DecodeOpCode::Bit:
+        return unscaled ? WireType::U8 : (pow2 ? WireType::F32 : WireType::F64);
+    case DecodeOpCode::Unsigned16:
+    case DecodeOpCode::Signed16:
+        return unscaled ? WireType::I32 : (pow2 ? WireType::F32 : WireType::F64);
+    case DecodeOpCode::Ieee754:
+        return pow2 ? WireType::F32 : WireType::F64;
+    case DecodeOpCode::UnsignedN:
+    case DecodeOpCode::SignedN:
+        if (unscaled && op.wordCount <= 2)
+            return op.op == DecodeOpCode::SignedN ? WireType::I32 : WireType::U32;
+        if (pow2 && op.wordCount * 16 <= 24) return WireType::F32;
+        return WireType::F64;
+    }
+    return WireType::F64;
+}
+
+BinaryEncoder::BinaryEncoder(const std::vector<FieldSpec>& fields, const std::vector<uint32_t>& fieldIds) {
+    if (!fieldIds.empty()) {
+        m_included.assign(fields.size(), 0);
+        for (uint32_t id : fieldIds) if (id < fields.size()) m_included[id] = 1;
+    }
+    // FNV-1a over field count, names and wire types
+    uint32_t h = 2166136261u;
+    auto mix = [&h](uint8_t b) { h = (h ^ b) * 16777619u; };
+    for (int i = 0; i < 4; ++i) mix(static_cast<uint8_t>(fields.size() >> (8 * i)));
+    for (const auto& f : fields) {
+        m_names.push_back(f.name);
+        m_types.push_back(defaultWireType(f));
+        for (char c : f.name) mix(static_cast<uint8_t>(c));
+        mix(0);
+        mix(static_cast<uint8_t>(m_types.back()));
+    }
+    m_schemaId = h;
+}
+
+uint8_t* BinaryEncoder::writeValue(uint8_t* p, uint32_t fieldId, double value) const {
+    switch (m_types[fieldId]) {
+    case WireType::U8: *p = saturate<uint8_t>(value); return p + 1;
+    case WireType::I32: putLE(p, static_cast<uint32_t>(saturate<int32_t>(value)), 4); return p + 4;
+    case WireType::U32: putLE(p, saturate<uint32_t>(value), 4); return p + 4;
+    case WireType::F32: {
+        float f = static_cast<float>(value);
+        uint32_t bits; std::memcpy(&bits, &f, sizeof(bits));
+        putLE(p, bits, 4);
+        return p + 4;
+    }
+    case WireType::F64: {
+        uint64_t bits; std::memcpy(&bits, &value, sizeof(bits));
+        putLE(p, bits, 8);
+        return p + 8;
+    }
+    }
+    return p;
+}
+
+void BinaryEncoder::encodeSnapshot(const ValueSnapshot& snap, uint64_t seq, std::string& out) const {
+    size_t n = std::min(m_types.size(), snap.valid.size());
+    size_t first = 0, last = 0; // present range [first, last)
+    size_t payload = 0;
+    uint64_t latestTs = 0;   // over the encoded fields only
+    const bool all = m_included.empty();
+    for (size_t id = 0; id < n; ++id) {
+        if (!snap.valid[id] || (!all && !m_included[id])) continue;
+        if (payload == 0) first = id;
+        last = id + 1;
+        payload += wireTypeSize(m_types[id]);
+        if (snap.timestamps[id] > latestTs) latestTs = snap.timestamps[id];
+    }
+    first &= ~size_t{7};
+    size_t bitmapBytes = (last - first + 7) / 8;
+    out.resize(kBinaryDataHeaderSize + bitmapBytes + payload);
+    auto* base = reinterpret_cast<uint8_t*>(&out[0]);
+    writeBinaryHeader(base, BinaryKind::Data, m_schemaId, seq, latestTs);
+    putLE(base + kBinaryHeaderSize, first, 4);
+    putLE(base + kBinaryHeaderSize + 4, bitmapBytes, 2);
+    putLE(base + kBinaryHeaderSize + 6, 0, 2);
+    uint8_t* bitmap = base + kBinaryDataHeaderSize;
+    std::memset(bitmap, 0, bitmapBytes);
+    uint8_t* p = bitmap + bitmapBytes;
+    for (size_t id = first; id < last; ++id) {
+        if (!snap.valid[id] || (!all && !m_included[id])) continue;
+        bitmap[(id - first) >> 3] |= static_cast<uint8_t>(1u << ((id - first) & 7));
+        p = writeValue(p, static_cast<uint32_t>(id), snap.values[id]);
+    }
+}
+
+void BinaryEncoder::encodeValue(const FieldValue& v, uint64_t seq, std::string& out) const {
+    if (v.fieldId >= m_types.size()) { out.clear(); return; }
+    out.resize(kBinaryDataHeaderSize + 1 + wireTypeSize(m_types[v.fieldId]));
+    auto* base = reinterpret_cast<uint8_t*>(&out[0]);
+    writeBinaryHeader(base, BinaryKind::Data, m_schemaId, seq, v.timestamp);
+    putLE(base + kBinaryHeaderSize, v.fieldId, 4);
+    putLE(base + kBinaryHeaderSize + 4, 1, 2);
+    putLE(base + kBinaryHeaderSize + 6, 0, 2);
+    base[kBinaryDataHeaderSize] = 1;
+    writeValue(base + kBinaryDataHeaderSize + 1, v.fieldId, v.value);
+}
+
+void BinaryEncoder::encodeSchema(uint64_t announcement, std::vector<std::string>& fragments) const {
+    fragments.clear();
+    // Group entries into fragments that fit kBinarySchemaMaxDatagram
+    std::vector<std::pair<size_t, size_t>> ranges; // [first, end) field ids
+    size_t first = 0, bytes = kBinarySchemaHeaderSize;
+    for (size_t id = 0; id < m_names.size(); ++id) {
+        size_t nameLen = std::min<size_t>(m_names[id].size(), 0xFFFF);
+        size_t entry = 3 + nameLen;
+        if (id > first && (bytes + entry > kBinarySchemaMaxDatagram || id - first == 0xFFFF)) {
+            ranges.emplace_back(first, id);
+            first = id;
+            bytes = kBinarySchemaHeaderSize;
+        }
+        bytes += entry;
+    }
+    ranges.emplace_back(first, m_names.size());
+
+    for (size_t f = 0; f < ranges.size(); ++f) {
+        std::string frag(kBinarySchemaHeaderSize, '\0');
+        auto* base = reinterpret_cast<uint8_t*>(&frag[0]);
+        writeBinaryHeader(base, BinaryKind::Schema, m_schemaId, announcement, 0);
+        putLE(base + kBinaryHeaderSize, f, 2);
+        putLE(base + kBinaryHeaderSize + 2, ranges.size(), 2);
+        putLE(base + kBinaryHeaderSize + 4, m_names.size(), 4);
+        putLE(base + kBinaryHeaderSize + 8, ranges[f].first, 4);
+        putLE(base + kBinaryHeaderSize + 12, ranges[f].second - ranges[f].first, 2);
+        putLE(base + kBinaryHeaderSize + 14, 0, 2);
+        for (size_t id = ranges[f].first; id < ranges[f].second; ++id) {
+            size_t nameLen = std::min<size_t>(m_names[id].size(), 0xFFFF);
+            uint8_t entry[3];
+            entry[0] = static_cast<uint8_t>(m_types[id]);
+            putLE(entry + 1, nameLen, 2);
+            frag.append(reinterpret_cast<const char*>(entry), 3);
+            frag.append(m_names[id], 0, nameLen);
+        }
+        fragments.push_back(std::move(frag));
+    }
+}
+
+} // namespace ddc
@@ -0,0 +1,87 @@
+#include "BusAnalyzer.hpp"
+#include <cmath>
+#include <sstream>
+
+namespace ddc {
+
+BusAnalyzer::BusAnalyzer(const std::vector<ExpectedRate>& expected)
+    : m_keys(new Key[kMsgKeySpace]),
+      m_periodUs(kMsgKeySpace, 0.0) {
+    for (const auto& e : expected)
+        if (msgKeyInRange(e.rt, e.subAddress) && e.rateHz > 0)
+            m_periodUs[msgKeyIndex(e.rt, e.subAddress, e.transmit)] = 1e6 / e.rateHz;
+}
+
+size_t BusAnalyzer::jitterBin(uint64_t deviationUs) {
+    size_t bin = 0;
+    while (deviationUs && bin < kJitterBins - 1) { deviationUs >>= 1; ++bin; }
+    return bin;
+}
+
+void BusAnalyzer::sample(Key& k, double periodUs, uint64_t gapUs) {
+    const bool firstGap = k.gaps.load(std::memory_order_relaxed) == 0;
+    singleWriterAdd(k.gaps, 1);
+    singleWriterAdd(k.gapSumUs, gapUs);
+    if (gapUs < k.minGapUs.load(std::memory_order_relaxed)) k.minGapUs.store(gapUs, std::memory_order_relaxed);
+    if (gapUs > k.maxGapUs.load(std::memory_order_relaxed)) k.maxGapUs.store(gapUs, std::memory_order_relaxed);
+    const uint64_t prev = k.prevGapUs.load(std::memory_order_relaxed);
+    k.prevGapUs.store(gapUs, std::memory_order_relaxed);
+    double reference = periodUs;
+    if (periodUs > 0) {
+        // A gap of n periods: n - 1 slots went by without the message
+        const double slots = std::floor(static_cast<double>(gapUs) / periodUs + 0.5);
+        if (slots > 1) {
+            singleWriterAdd(k.missed, static_cast<uint64_t>(slots) - 1);
+            reference = slots * periodUs;  // jitter of the message against its own slot
+        }
+    } else {
+        if (firstGap) return;              // nothing to compare with yet
+        reference = static_cast<double>(prev);
+    }
+    const double deviation = std::fabs(static_cast<double>(gapUs) - reference);
+    singleWriterAdd(k.jitter[jitterBin(static_cast<uint64_t>(deviation))], 1);
+    singleWriterAdd(k.jitterSamples, 1);
+    singleWriterAdd(k.jitterSumSq, deviation * deviation);
+}
+
+void BusAnalyzer::snapshot(std::vector<KeyStats>& out) const {
+    out.resize(kMsgKeySpace);
+    for (size_t key = 0; key < kMsgKeySpace; ++key) {
+        const Key& k = m_keys[key];
+        KeyStats& s = out[key];
+        s.messages = k.messages.load(std::memory_order_relaxed);
+        s.gaps = k.gaps.load(std::memory_order_relaxed);
+        s.gapSumUs = k.gapSumUs.load(std::memory_order_relaxed);
+        s.minGapUs = s.gaps ? k.minGapUs.load(std::memory_order_relaxed) : 0;
+        s.maxGapUs = k.maxGapUs.load(std::memory_order_relaxed);
+        s.missed = k.missed.load(std::memory_order_relaxed);
+        s.outOfOrder = k.outOfOrder.load(std::memory_order_relaxed);
+        s.lastUs = k.lastUs.load(std::memory_order_relaxed);
+        s.expectedHz = m_periodUs[key] > 0 ? 1e6 / m_periodUs[key] : 0.0;
+        const uint64_t samples = k.jitterSamples.load(std::memory_order_relaxed);
+        s.jitterRmsUs = samples ? std::sqrt(k.jitterSumSq.load(std::memory_order_relaxed) / static_cast<double>(samples)) : 0.0;
+        for (size_t b = 0; b < kJitterBins; ++b) s.jitter[b] = k.jitter[b].load(std::memory_order_relaxed);
+    }
+}
+
+std::string BusAnalyzer::report() const {
+    std::vector<KeyStats> keys;
+    snapshot(keys);
+    std::ostringstream os;
+    os.precision(2);
+    os << std::fixed;
+    for (size_t key = 0; key < keys.size(); ++key) {
+        const KeyStats& s = keys[key];
+        if (!s.messages && s.expectedHz <= 0) continue;
+        os << (key >> 6) << "-" << ((key >> 1) & 31) << ((key & 1) ? "T" : "R") << ": messages " << s.messages
+           << ", rate " << s.rateHz() << " Hz";
+        if (s.expectedHz > 0) os << " (expected " << s.expectedHz << "), missed " << s.missed;
+        os << ", gap min/mean/max " << s.minGapUs << "/" << s.meanGapUs() << "/" << s.maxGapUs
+           << " us, jitter rms " << s.jitterRmsUs << " us";
+        if (s.outOfOrder) os << ", out of order " << s.outOfOrder;
+        os << "\n";
+    }
+    return os.str();
+}
+
+} // namespace ddc
@@ -0,0 +1,159 @@
+#include "BusSimulator.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ddc {
+
+namespace {
+
+constexpr double kTwoPi = 6.283185307179586;
+
+// Command word, data words and status word at 20 us each, plus response time and gap
+uint32_t busTimeUs(uint16_t words) { return (static_cast<uint32_t>(words) + 2) * 20 + 10; }
+
+} // namespace
+
+BusSimulator::BusSimulator(const AppConfig& cfg) {
+    std::vector<SimScheduleEntry> schedule = cfg.simSchedule;
+    if (schedule.empty()) {
+        // One entry per field key, sized to the highest word used; sim_rate_hz is the total
+        for (const auto& stream : cfg.streams) {
+            for (const auto& f : stream.fields) {
+                if (!msgKeyInRange(f.rt, f.subAddress)) continue;
+                auto it = std::find_if(schedule.begin(), schedule.end(), [&](const SimScheduleEntry& e) {
+                    return e.rt == f.rt && e.subAddress == f.subAddress && e.transmit == f.transmit;
+                });
+                int last = std::clamp(std::max(f.startWord, f.endWord), 1, static_cast<int>(kMax1553DataWords));
+                if (it == schedule.end()) {
+                    SimScheduleEntry e;
+                    e.rt = f.rt; e.subAddress = f.subAddress; e.transmit = f.transmit;
+                    e.wordCount = static_cast<uint16_t>(last);
+                    schedule.push_back(e);
+                } else {
+                    it->wordCount = std::max(it->wordCount, static_cast<uint16_t>(last));
+                }
+            }
+        }
+        if (schedule.empty()) {
+            SimScheduleEntry e; e.rt = 5; e.subAddress = 17;
+            schedule.push_back(e);
+            e.subAddress = 22;
+            schedule.push_back(e);
+        }
+        double rate = (cfg.simRateHz > 0 ? cfg.simRateHz : 50.0) / static_cast<double>(schedule.size());
+        for (auto& e : schedule) e.rateHz = rate;
+    }
+
+    double fastest = 0.0;
+    for (const auto& e : schedule) fastest = std::max(fastest, e.rateHz);
+    m_minorFrameHz = cfg.simMinorFrameHz > 0 ? cfg.simMinorFrameHz : std::min(fastest, kMaxDefaultMinorFrameHz);
+    m_frameUs = 1e6 / m_minorFrameHz;
+    m_randomFill = cfg.simPattern != "increment";
+
+    std::vector<FieldSpec> fields;
+    for (const auto& stream : cfg.streams)
+        for (const auto& f : stream.fields) fields.push_back(f);
+    for (const auto& spec : schedule) {
+        Entry e;
+        e.spec = spec;
+        e.creditPerFrame = spec.rateHz / m_minorFrameHz;
+        e.credit = e.creditPerFrame < 1.0 ? 1.0 - e.creditPerFrame : 0.0; // slow entries start in frame 0
+        e.busUs = busTimeUs(spec.wordCount);
+        for (uint32_t id = 0; id < fields.size(); ++id) {
+            const auto& f = fields[id];
+            if (f.sim.pattern.empty() || f.rt != spec.rt || f.subAddress != spec.subAddress || f.transmit != spec.transmit)
+                continue;
+            bool valid = false;
+            DecodeOp op = ExtractionPlan::compile(f, id, valid);
+            if (!valid || op.minWords > spec.wordCount) continue;
+            Pattern p = f.sim.pattern == "ramp" ? Pattern::Ramp
+                      : f.sim.pattern == "sine" ? Pattern::Sine
+                      : f.sim.pattern == "counter" ? Pattern::Counter : Pattern::Random;
+            e.fields.push_back({op, p, f.sim});
+        }
+        m_messagesPerSecond += spec.rateHz;
+        m_scheduledLoad += spec.rateHz * e.busUs / 1e6;
+        m_entries.push_back(std::move(e));
+    }
+}
+
+size_t BusSimulator::nextFrame(std::vector<Raw1553Message>& out, const AcceptanceMask* accept) {
+    const uint64_t frameStartUs = static_cast<uint64_t>(std::llround(static_cast<double>(m_frame) * m_frameUs));
+    // A message may start up to one frame late (bursts spill over); later than that it is dropped
+    const uint64_t latestStartUs = static_cast<uint64_t>(std::llround(static_cast<double>(m_frame + 2) * m_frameUs));
+    ++m_frame;
+    // Whole credits due this frame; fast entries are interleaved round-robin
+    uint64_t rounds = 0;
+    m_due.resize(m_entries.size());
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        auto& e = m_entries[i];
+        e.credit += e.creditPerFrame;
+        double whole = std::floor(e.credit + 1e-9);
+        e.credit -= whole;
+        m_due[i] = static_cast<uint32_t>(whole);
+        rounds = std::max<uint64_t>(rounds, m_due[i]);
+    }
+    size_t before = out.size();
+    for (uint64_t r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < m_entries.size(); ++i) {
+            if (m_due[i] <= r) continue;
+            auto& e = m_entries[i];
+            const uint64_t ts = std::max(m_busCursorUs, frameStartUs);
+            if (ts >= latestStartUs) { ++m_overflowed; continue; }
+            m_busCursorUs = ts + e.busUs;
+            m_busBusyUs += e.busUs;
+            ++m_messages;
+            if (accept && !accept->acceptsKey(msgKeyIndex(e.spec.rt, e.spec.subAddress, e.spec.transmit))) { ++e.sent; continue; }
+            out.emplace_back();
+            Raw1553Message& msg = out.back();
+            msg.rtAddress = e.spec.rt;
+            msg.subAddress = e.spec.subAddress;
+            msg.tx = e.spec.transmit;
+            msg.wordCount = e.spec.wordCount;
+            msg.isModeCode = false;
+            msg.dataWordCount = e.spec.wordCount;
+            msg.channel = (e.spec.channels == 0x3) ? static_cast<uint16_t>(e.sent & 1) : (e.spec.channels == 0x2 ? 1 : 0);
+            msg.timestamp = ts;
+            msg.statusWord1 = static_cast<uint32_t>(e.spec.rt) << 11; // status word carries the RT address
+            msg.statusWord2 = 0;
+            fill(e, msg);
+            ++e.sent;
+        }
+    }
+    return out.size() - before;
+}
+
+void BusSimulator::fill(Entry& e, Raw1553Message& msg) {
+    for (uint16_t i = 0; i < e.spec.wordCount; ++i)
+        msg.dataWords[i] = m_randomFill ? static_cast<uint16_t>(m_rng()) : m_increment++;
+    const double t = static_cast<double>(msg.timestamp) / 1e6;
+    for (const auto& f : e.fields) {
+        const FieldSim& s = f.sim;
+        double v;
+        switch (f.pattern) {
+        case Pattern::Counter:
+            encodeFieldRaw(f.op, e.sent, msg.dataWords.data());
+            continue;
+        case Pattern::Ramp: {
+            double phase = t / s.periodSec;
+            v = s.min + (s.max - s.min) * (phase - std::floor(phase));
+            break;
+        }
+        case Pattern::Sine:
+            v = 0.5 * (s.min + s.max) + 0.5 * (s.max - s.min) * std::sin(kTwoPi * t / s.periodSec);
+            break;
+        default:
+            v = std::uniform_real_distribution<double>(s.min, s.max)(m_rng);
+            break;
+        }
+        encodeField(f.op, v, msg.dataWords.data());
+    }
+}
+
+double BusSimulator::busLoad() const {
+    // Elapsed bus time includes a burst still running past the last frame
+    const double elapsedUs = std::max(static_cast<double>(m_frame) * m_frameUs, static_cast<double>(m_busCursorUs));
+    return elapsedUs > 0.0 ? static_cast<double>(m_busBusyUs) / elapsedUs : 0.0;
+}
+
+} // namespace ddc
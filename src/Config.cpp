@@ -1,4 +1,5 @@
 #include "Config.hpp"
+#include "BinaryFormat.hpp"
 #include <nlohmann/json.hpp>
 #include <fstream>
 #include <cmath>
@@ -33,6 +34,130 @@ static bool parseField(const nlohmann::json& jf, FieldSpec& f, std::string& err)
             f.lsbScale = jf.at("lsb").get<double>();
         }
         f.type = jf.value("type", "raw");
+        f.sim.pattern = jf.value("sim_pattern", std::string());
+        if (!f.sim.pattern.empty() && f.sim.pattern != "ramp" && f.sim.pattern != "sine" &&
+            f.sim.pattern != "counter" && f.sim.pattern != "random") {
+            err = "sim_pattern must be ramp, sine, counter or random (field " + f.name + ")";
+            return false;
+        }
+        f.sim.min = jf.value("sim_min", f.sim.min);
+        f.sim.max = jf.value("sim_max", f.sim.max);
+        f.sim.periodSec = jf.value("sim_period_s", f.sim.periodSec);
+        if (!(f.sim.periodSec > 0)) { err = "sim_period_s must be > 0 (field " + f.name + ")"; return false; }
+        for (const char* key : {"deadband", "deadband_pct", "min_interval_ms", "max_interval_ms"})
+            f.report.enabled = f.report.enabled || jf.contains(key);
+        f.report.deadband = jf.value("deadband", f.report.deadband);
+        f.report.deadbandPct = jf.value("deadband_pct", f.report.deadbandPct);
+        if (f.report.deadband < 0 || f.report.deadbandPct < 0) { err = "deadband must be >= 0 (field " + f.name + ")"; return false; }
+        f.report.minIntervalMs = jf.value("min_interval_ms", f.report.minIntervalMs);
+        f.report.maxIntervalMs = jf.value("max_interval_ms", f.report.maxIntervalMs);
+        auto aggregate = jf.value("aggregate", std::string("last"));
+        if (aggregate == "last") f.aggregate = Aggregate::Last;
+        else if (aggregate == "min") f.aggregate = Aggregate::Min;
+        else if (aggregate == "max") f.aggregate = Aggregate::Max;
+        else if (aggregate == "mean") f.aggregate = Aggregate::Mean;
+        else if (aggregate == "count") f.aggregate = Aggregate::Count;
+        else if (aggregate == "rms") f.aggregate = Aggregate::Rms;
+        else { err = "aggregate must be last, min, max, mean, count or rms (field " + f.name + ")"; return false; }
+        f.wireType = jf.value("wire_type", std::string());
+        WireType wt;
+        if (!f.wireType.empty() && !parseWireType(f.wireType, wt)) {
+            err = "wire_type must be u8, i32, u32, f32 or f64 (field " + f.name + ")";
+            return false;
+        }
+        return true;
+    } catch (const std::exception& e) { err = e.what(); return false; }
+}
+
+// "rt" + "message" ("17R" / "22T", same form as fields) of a sim_schedule / expected_rates entry
+static bool parseEntryKey(const nlohmann::json& je, const char* what, uint16_t& rtOut, uint16_t& saOut,
+                          bool& txOut, std::string& err) {
+    int rt = je.at("rt").get<int>();
+    auto msg = je.at("message").get<std::string>();
+    if (msg.size() < 2) { err = std::string(what) + " message format"; return false; }
+    int sa = std::stoi(msg.substr(0, msg.size()-1));
+    char dir = (char)std::toupper(msg.back());
+    if (rt < 0 || rt > 31 || sa < 0 || sa > 31 || (dir != 'R' && dir != 'T')) {
+        err = std::string(what) + " entry out of range: rt " + std::to_string(rt) + " message " + msg;
+        return false;
+    }
+    rtOut = static_cast<uint16_t>(rt);
+    saOut = static_cast<uint16_t>(sa);
+    txOut = (dir == 'T');
+    return true;
+}
+
+static bool parseScheduleEntry(const nlohmann::json& je, SimScheduleEntry& e, std::string& err) {
+    try {
+        if (!parseEntryKey(je, "sim_schedule", e.rt, e.subAddress, e.transmit, err)) return false;
+        int words = je.value("words", 32);
+        if (words < 1 || words > 32) { err = "sim_schedule words must be 1-32"; return false; }
+        e.wordCount = static_cast<uint16_t>(words);
+        e.rateHz = je.value("rate_hz", e.rateHz);
+        if (!(e.rateHz > 0)) { err = "sim_schedule rate_hz must be > 0"; return false; }
+        auto ch = je.value("channel", std::string("A"));
+        if (ch == "A") e.channels = 0x1;
+        else if (ch == "B") e.channels = 0x2;
+        else if (ch == "AB") e.channels = 0x3;
+        else { err = "sim_schedule channel must be A, B or AB"; return false; }
+        return true;
+    } catch (const std::exception& e) { err = e.what(); return false; }
+}
+
+static bool parseExpectedRate(const nlohmann::json& je, ExpectedRate& e, std::string& err) {
+    try {
+        if (!parseEntryKey(je, "expected_rates", e.rt, e.subAddress, e.transmit, err)) return false;
+        e.rateHz = je.at("rate_hz").get<double>();
+        if (!(e.rateHz > 0)) { err = "expected_rates rate_hz must be > 0"; return false; }
+        return true;
+    } catch (const std::exception& e) { err = e.what(); return false; }
+}
+
+static bool parseDevice(const nlohmann::json& jd, DeviceConfig& d, std::string& err) {
+    try {
+        if (jd.is_string()) { d.name = jd.get<std::string>(); return true; }
+        d.name = jd.value("name", d.name);
+        d.channelMask = jd.value("channel_mask", d.channelMask);
+        if (jd.contains("sim_schedule")) {
+            d.simSchedule.clear();
+            for (auto& je : jd.at("sim_schedule")) {
+                SimScheduleEntry e;
+                if (!parseScheduleEntry(je, e, err)) return false;
+                d.simSchedule.push_back(e);
+            }
+        }
+        return true;
+    } catch (const std::exception& e) { err = e.what(); return false; }
+}
+
+static bool parseFormat(const std::string& s, OutputFormat& f, std::string& err) {
+    if (s == "json") f = OutputFormat::Json;
+    else if (s == "binary") f = OutputFormat::Binary;
+    else { err = "output_format must be json or binary"; return false; }
+    return true;
+}
+
+static bool parseSink(const nlohmann::json& js, const AppConfig& cfg, SinkConfig& s, std::string& err) {
+    try {
+        s.host = js.value("host", s.host);
+        int port = js.value("port", 0);
+        if (port < 0 || port > 65535) { err = "sink port out of range"; return false; }
+        s.port = static_cast<uint16_t>(port);
+        s.multicastTtl = js.value("ttl", s.multicastTtl);
+        if (s.multicastTtl < 0 || s.multicastTtl > 255) { err = "sink ttl must be 0-255"; return false; }
+        s.multicastInterface = js.value("interface", std::string());
+        s.rateHz = js.value("rate_hz", s.rateHz);
+        if (!(s.rateHz > 0)) { err = "sink rate_hz must be > 0"; return false; }
+        s.batch = js.value("batch", s.batch);
+        if (js.contains("format") && !parseFormat(js.at("format").get<std::string>(), s.format, err)) return false;
+        if (js.contains("streams")) {
+            for (auto& name : js.at("streams")) {
+                s.streams.push_back(name.get<std::string>());
+                bool known = false;
+                for (auto& sc : cfg.streams) if (sc.name == s.streams.back()) { known = true; break; }
+                if (!known) { err = "sink references unknown stream " + s.streams.back(); return false; }
+            }
+        }
         return true;
     } catch (const std::exception& e) { err = e.what(); return false; }
 }
@@ -45,17 +170,68 @@ std::optional<AppConfig> ConfigLoader::loadFromFile(const std::string& path, std
     // Default port aligned with PlotJuggler python examples (9870)
     cfg.udpPort = j.value("udp_port", 9870);
     cfg.udpHost = j.value("udp_host", std::string("127.0.0.1"));
+    cfg.udpSendBuffer = j.value("udp_sndbuf", 0);
+    if (cfg.udpSendBuffer < 0) { err = "udp_sndbuf must be >= 0"; return std::nullopt; }
     cfg.device = j.value("device", std::string("ACE0"));
     cfg.channelMask = j.value("channel_mask", 0x3u);
     cfg.outputRateHz = j.value("output_rate_hz", 50.0);
     cfg.batchMessages = j.value("batch", false);
     cfg.csvPath = j.value("csv_path", std::string());
+    cfg.csvOnChange = j.value("csv_on_change", cfg.csvOnChange);
+    cfg.recordPath = j.value("record_path", std::string());
+    cfg.replayPath = j.value("replay_path", std::string());
+    cfg.replaySpeed = j.value("replay_speed", cfg.replaySpeed);
+    if (cfg.replaySpeed < 0) { err = "replay_speed must be >= 0"; return std::nullopt; }
     cfg.simulation = j.value("simulation", false);
     cfg.simRateHz = j.value("sim_rate_hz", 50.0);
     cfg.simPattern = j.value("sim_pattern", std::string("random"));
+    cfg.simMinorFrameHz = j.value("sim_minor_frame_hz", cfg.simMinorFrameHz);
+    if (cfg.simMinorFrameHz < 0) { err = "sim_minor_frame_hz must be >= 0"; return std::nullopt; }
+    if (j.contains("sim_schedule")) {
+        for (auto& je : j["sim_schedule"]) {
+            SimScheduleEntry e;
+            if (!parseScheduleEntry(je, e, err)) return std::nullopt;
+            cfg.simSchedule.push_back(e);
+        }
+    }
+    cfg.queueCapacity = j.value("queue_capacity", cfg.queueCapacity);
+    if (cfg.queueCapacity == 0 || cfg.queueCapacity > kMaxQueueCapacity) {
+        err = "queue_capacity must be between 1 and " + std::to_string(kMaxQueueCapacity);
+        return std::nullopt;
+    }
+    cfg.latencyStats = j.value("latency_stats", cfg.latencyStats);
+    cfg.statsIntervalMs = j.value("stats_interval_ms", cfg.statsIntervalMs);
+    if (cfg.statsIntervalMs < 0) { err = "stats_interval_ms must be >= 0"; return std::nullopt; }
+    cfg.statsPort = j.value("stats_port", cfg.statsPort);
+    cfg.statsHost = j.value("stats_host", cfg.udpHost);
+    cfg.configPollMs = j.value("config_poll_ms", cfg.configPollMs);
+    if (cfg.configPollMs < 0) { err = "config_poll_ms must be >= 0"; return std::nullopt; }
+    cfg.generatedDecoders = j.value("generated_decoders", cfg.generatedDecoders);
+    cfg.acceptanceFilter = j.value("acceptance_filter", cfg.acceptanceFilter);
+    cfg.busAnalyzer = j.value("bus_analyzer", cfg.busAnalyzer);
+    if (j.contains("expected_rates")) {
+        for (auto& je : j["expected_rates"]) {
+            ExpectedRate e;
+            if (!parseExpectedRate(je, e, err)) return std::nullopt;
+            cfg.expectedRates.push_back(e);
+        }
+    }
+    int64_t workers = j.value("workers", static_cast<int64_t>(cfg.workers));
+    if (workers < 0 || workers > 64) { err = "workers must be 0..64"; return std::nullopt; }
+    cfg.workers = static_cast<size_t>(workers);
+    auto policy = j.value("queue_overflow", std::string("block"));
+    if (policy == "block") cfg.queuePolicy = OverflowPolicy::Block;
+    else if (policy == "drop_newest") cfg.queuePolicy = OverflowPolicy::DropNewest;
+    else if (policy == "drop_oldest") cfg.queuePolicy = OverflowPolicy::DropOldest;
+    else { err = "queue_overflow must be block, drop_newest or drop_oldest"; return std::nullopt; }
+    if (!parseFormat(j.value("output_format", std::string("json")), cfg.outputFormat, err)) return std::nullopt;
+    cfg.schemaIntervalMs = j.value("schema_interval_ms", cfg.schemaIntervalMs);
+    if (cfg.schemaIntervalMs <= 0) { err = "schema_interval_ms must be > 0"; return std::nullopt; }
     if (j.contains("streams")) {
         for (auto& js : j["streams"]) {
             StreamConfig sc; sc.name = js.value("name", std::string());
+            sc.rateHz = js.value("rate_hz", sc.rateHz);
+            if (sc.rateHz < 0) { err = "stream rate_hz must be >= 0 (stream " + sc.name + ")"; return std::nullopt; }
             if (js.contains("fields")) {
                 for (auto& jf : js["fields"]) {
                     FieldSpec f; if (parseField(jf, f, err)) sc.fields.push_back(f); else return std::nullopt;
@@ -64,6 +240,42 @@ std::optional<AppConfig> ConfigLoader::loadFromFile(const std::string& path, std
             cfg.streams.push_back(std::move(sc));
         }
     }
+    // Top-level device keys are the defaults for every device
+    DeviceConfig device;
+    device.name = cfg.device;
+    device.channelMask = cfg.channelMask;
+    device.simSchedule = cfg.simSchedule;
+    if (j.contains("devices")) {
+        for (auto& jd : j["devices"]) {
+            DeviceConfig d = device;
+            if (!parseDevice(jd, d, err)) return std::nullopt;
+            cfg.devices.push_back(std::move(d));
+        }
+        if (cfg.devices.empty()) { err = "devices must not be empty"; return std::nullopt; }
+        // Recordings keep the bus tag in 6 bits
+        if (cfg.devices.size() > 64) { err = "at most 64 devices"; return std::nullopt; }
+    } else {
+        cfg.devices.push_back(device);
+    }
+    int64_t window = j.value("merge_window_us", static_cast<int64_t>(cfg.mergeWindowUs));
+    if (window < 0) { err = "merge_window_us must be >= 0"; return std::nullopt; }
+    cfg.mergeWindowUs = static_cast<uint64_t>(window);
+    // Top-level output keys are the defaults for every sink
+    SinkConfig defaults;
+    defaults.host = cfg.udpHost;
+    defaults.rateHz = cfg.outputRateHz;
+    defaults.batch = cfg.batchMessages;
+    defaults.format = cfg.outputFormat;
+    if (j.contains("sinks")) {
+        for (auto& js : j["sinks"]) {
+            SinkConfig s = defaults;
+            if (!parseSink(js, cfg, s, err)) return std::nullopt;
+            cfg.sinks.push_back(std::move(s));
+        }
+        if (cfg.sinks.empty()) { err = "sinks must not be empty"; return std::nullopt; }
+    } else {
+        cfg.sinks.push_back(defaults);
+    }
     return cfg;
 }
 
@@ -0,0 +1,73 @@
+#include "ConfigReloader.hpp"
+#include <chrono>
+#include <filesystem>
+
+namespace ddc {
+
+ConfigReloader::ConfigReloader(const AppConfig& running, ExtractionEngine& engine, OutputFanout& output)
+    : m_running(running), m_engine(engine), m_output(output) {}
+
+ConfigReloader::~ConfigReloader() { stop(); }
+
+void ConfigReloader::start(const std::string& path, int pollMs, Notify notify) {
+    if (m_thread.joinable()) return;
+    m_stop = false;
+    m_thread = std::thread([this, path, pollMs, notify = std::move(notify)] { run(path, pollMs, notify); });
+}
+
+void ConfigReloader::stop() {
+    m_stop = true;
+    if (m_thread.joinable()) m_thread.join();
+}
+
+bool ConfigReloader::apply(const AppConfig& next, std::string& err) {
+    // Batch ticks, aggregation windows and sink selections are laid out per stream
+    if (next.streams.size() != m_running.streams.size()) {
+        err = "streams added or removed (restart to apply)";
+        return false;
+    }
+    for (size_t i = 0; i < next.streams.size(); ++i) {
+        if (next.streams[i].name != m_running.streams[i].name || next.streams[i].rateHz != m_running.streams[i].rateHz) {
+            err = "stream '" + m_running.streams[i].name + "' renamed or rate_hz changed (restart to apply)";
+            return false;
+        }
+    }
+    // Output first: its new tables cover every id the new engine tables can produce, and
+    // every id the old ones still have in flight
+    std::unique_ptr<ExtractionTables> tables = m_engine.prepare(next);
+    m_output.reload(*tables);
+    std::unique_ptr<ExtractionTables> previous = m_engine.install(std::move(tables));
+    m_engine.rcu().synchronize();
+    m_output.freeRetired();
+    previous.reset();
+    m_reloads.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void ConfigReloader::run(std::string path, int pollMs, Notify notify) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::file_time_type seen = fs::last_write_time(path, ec);
+    auto nextPoll = std::chrono::steady_clock::now();
+    while (!m_stop.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        bool due = m_requested.exchange(false);
+        if (!due && pollMs > 0 && std::chrono::steady_clock::now() >= nextPoll) {
+            nextPoll = std::chrono::steady_clock::now() + std::chrono::milliseconds(pollMs);
+            fs::file_time_type t = fs::last_write_time(path, ec);
+            // A half-written file fails to parse; the editor's final write changes the time again
+            if (!ec && t != seen) { seen = t; due = true; }
+        }
+        if (!due) continue;
+        std::string err;
+        auto next = ConfigLoader::loadFromFile(path, err);
+        bool ok = next && apply(*next, err);
+        if (!ok) m_failures.fetch_add(1, std::memory_order_relaxed);
+        if (!notify) continue;
+        size_t fields = 0;
+        if (ok) for (const auto& sc : next->streams) fields += sc.fields.size();
+        notify(ok, path + ": " + (ok ? std::to_string(fields) + " fields" : err));
+    }
+}
+
+} // namespace ddc
@@ -1,17 +1,26 @@
 #include "CsvLogger.hpp"
-#include <sstream>
-#include <unordered_set>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
 
 namespace ddc {
 
+CsvLogger::CsvLogger() : m_ring(kQueueRecords, OverflowPolicy::Block) {}
+
+CsvLogger::~CsvLogger() { close(); }
+
 bool CsvLogger::open(const std::string& path) {
+    if (m_writer.joinable()) return false;
     m_ofs.open(path, std::ios::out | std::ios::trunc);
-    return static_cast<bool>(m_ofs);
+    if (!m_ofs) return false;
+    m_block.reserve(kBlockBytes + 4096);
+    m_stop = false;
+    m_writer = std::thread([this] { run(); });
+    return true;
 }
 
 void CsvLogger::setColumns(const std::vector<std::string>& names) {
-    std::lock_guard<std::mutex> lk(m_mtx);
-    if (m_headerWritten) return; // cannot change after header
+    if (m_writer.joinable()) return; // cannot change once writing
     m_columnsOriginal = names;
     m_columnsCsv.clear();
     m_columnsCsv.reserve(names.size());
@@ -20,44 +29,108 @@ void CsvLogger::setColumns(const std::vector<std::string>& names) {
         for (auto &ch : c) if (ch == '.') ch = '/';
         m_columnsCsv.push_back(std::move(c));
     }
+    m_lastValues.assign(names.size(), 0.0);
+    m_seen.assign(names.size(), 0);
 }
 
-void CsvLogger::writeValues(const std::vector<ExtractedValue>& values) {
-    if (values.empty()) return;
-    std::lock_guard<std::mutex> lk(m_mtx);
-    // Update last-values map
-    for (auto &v : values) {
-        m_lastValues[v.name] = v.numericValue;
-        // If a new column appears that wasn't declared, append (fallback)
-        if (!m_headerWritten && std::find(m_columnsOriginal.begin(), m_columnsOriginal.end(), v.name) == m_columnsOriginal.end()) {
-            m_columnsOriginal.push_back(v.name);
-            std::string c = v.name; for (auto &ch : c) if (ch == '.') ch = '/';
-            m_columnsCsv.push_back(std::move(c));
+void CsvLogger::writeValues(const FieldValue* values, size_t count) {
+    if (count == 0 || !m_writer.joinable()) return;
+    // Use timestamp of first updated value for the row; split across records if needed
+    Record r;
+    r.timestamp = values[0].timestamp;
+    r.flush = 0;
+    for (size_t done = 0; done < count;) {
+        size_t n = std::min(count - done, kRecordValues);
+        for (size_t i = 0; i < n; ++i) {
+            r.values[i].fieldId = values[done + i].fieldId;
+            r.values[i].value = values[done + i].value;
         }
+        r.count = static_cast<uint32_t>(n);
+        done += n;
+        r.endOfRow = done == count;
+        m_ring.push(r);
     }
-    if (!m_headerWritten) {
-        if (m_columnsOriginal.empty()) { // fallback to current values ordering
-            for (auto &v : values) {
-                m_columnsOriginal.push_back(v.name);
-                std::string c = v.name; for (auto &ch : c) if (ch == '.') ch = '/';
-                m_columnsCsv.push_back(std::move(c));
+}
+
+void CsvLogger::flush() {
+    if (!m_writer.joinable()) return;
+    uint64_t target = m_flushRequests.fetch_add(1) + 1;
+    Record r;
+    r.timestamp = 0;
+    r.count = 0;
+    r.endOfRow = 0;
+    r.flush = 1;
+    m_ring.push(r);
+    while (m_flushesDone.load() < target) std::this_thread::sleep_for(std::chrono::microseconds(200));
+}
+
+void CsvLogger::close() {
+    if (!m_writer.joinable()) return;
+    m_stop = true;
+    m_writer.join();
+    m_ofs.close();
+}
+
+void CsvLogger::run() {
+    Record r;
+    auto lastWrite = std::chrono::steady_clock::now();
+    for (;;) {
+        if (m_ring.pop(r)) {
+            if (r.flush) {
+                writeBlock();
+                m_ofs.flush();
+                m_flushesDone.fetch_add(1);
+                continue;
+            }
+            // Update last values; ids beyond the declared columns are ignored
+            for (uint32_t i = 0; i < r.count; ++i) {
+                uint32_t id = r.values[i].fieldId;
+                if (id >= m_lastValues.size()) continue;
+                m_lastValues[id] = r.values[i].value;
+                m_seen[id] = 1;
             }
+            if (r.endOfRow) appendRow(r.timestamp);
+            if (m_block.size() >= kBlockBytes) { writeBlock(); lastWrite = std::chrono::steady_clock::now(); }
+            continue;
         }
-        m_ofs << "timestamp";
-        for (auto &col : m_columnsCsv) m_ofs << "," << col;
-        m_ofs << "\n";
+        if (m_stop.load()) {
+            if (m_ring.size() != 0) continue; // pushed just before close()
+            break;
+        }
+        // Idle: don't let a slow trickle of rows sit in memory indefinitely
+        auto now = std::chrono::steady_clock::now();
+        if (!m_block.empty() && now - lastWrite > std::chrono::milliseconds(200)) { writeBlock(); lastWrite = now; }
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    writeBlock();
+    m_ofs.flush();
+}
+
+void CsvLogger::appendRow(uint64_t ts) {
+    if (!m_headerWritten) {
+        m_block += "timestamp";
+        for (auto &col : m_columnsCsv) { m_block += ','; m_block += col; }
+        m_block += '\n';
         m_headerWritten = true;
     }
-    // Use timestamp of first updated value for the row
-    uint64_t ts = values.front().timestamp;
-    m_ofs << ts;
-    for (auto &orig : m_columnsOriginal) {
-        auto it = m_lastValues.find(orig);
-        if (it != m_lastValues.end()) m_ofs << "," << it->second; else m_ofs << ","; // blank if unseen yet
+    // Same text as ostream's default formatting (%g, 6 significant digits)
+    char buf[64];
+    auto res = std::to_chars(buf, buf + sizeof(buf), ts);
+    m_block.append(buf, res.ptr);
+    for (size_t c = 0; c < m_lastValues.size(); ++c) {
+        m_block += ',';
+        if (!m_seen[c]) continue; // blank if unseen yet
+        res = std::to_chars(buf, buf + sizeof(buf), m_lastValues[c], std::chars_format::general, 6);
+        m_block.append(buf, res.ptr);
     }
-    m_ofs << "\n";
+    m_block += '\n';
+    m_rows.fetch_add(1, std::memory_order_relaxed);
 }
 
-void CsvLogger::flush() { std::lock_guard<std::mutex> lk(m_mtx); m_ofs.flush(); }
+void CsvLogger::writeBlock() {
+    if (m_block.empty()) return;
+    m_ofs.write(m_block.data(), static_cast<std::streamsize>(m_block.size()));
+    m_block.clear();
+}
 
 } // namespace ddc
@@ -1,5 +1,6 @@
 #include "ExtractionEngine.hpp"
 #include <nlohmann/json.hpp>
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 #include <string>
@@ -10,73 +11,119 @@
 
 namespace ddc {
 
-ExtractionEngine::ExtractionEngine(const AppConfig& cfg) : m_cfg(cfg) {
-    for (const auto& stream : cfg.streams) {
-        for (const auto& f : stream.fields) {
-            MsgKey k{f.rt, f.subAddress, f.transmit};
-            m_lookup[k].push_back(f);
-        }
+namespace {
+
+// Upper bound on batch ticks: OutputFanout merges sinks into groups and ticks each group
+// once per distinct stream rate (plus the sink's own)
+size_t batchWindows(const AppConfig& cfg) {
+    std::vector<double> rates;
+    for (const auto& sc : cfg.streams)
+        if (sc.rateHz > 0 && std::find(rates.begin(), rates.end(), sc.rateHz) == rates.end()) rates.push_back(sc.rateHz);
+    size_t sinks = cfg.sinks.empty() ? (cfg.batchMessages ? 1 : 0)
+                 : static_cast<size_t>(std::count_if(cfg.sinks.begin(), cfg.sinks.end(), [](const SinkConfig& s) { return s.batch; }));
+    return sinks * (rates.size() + 1);
+}
+
+} // namespace
+
+#if !DDC_GENERATED_DECODERS
+const GeneratedDecoders* generatedDecoders() { return nullptr; }
+#endif
+
+ExtractionTables::ExtractionTables(const AppConfig& cfg, const ExtractionPlan* previous, size_t windows)
+    : plan(cfg, previous), store(plan, windows) {
+    const GeneratedDecoders* g = cfg.generatedDecoders ? generatedDecoders() : nullptr;
+    if (g && g->signature == plan.signature()) generated = g;
+}
+
+ExtractionEngine::ExtractionEngine(const AppConfig& cfg)
+    : m_windows(batchWindows(cfg)),
+      m_current(std::make_unique<ExtractionTables>(cfg, nullptr, m_windows)),
+      m_tables(m_current.get()) {}
+
+std::unique_ptr<ExtractionTables> ExtractionEngine::prepare(const AppConfig& cfg) const {
+    const ExtractionTables& current = *m_current;
+    auto next = std::make_unique<ExtractionTables>(cfg, &current.plan, m_windows);
+    next->generation = current.generation + 1;
+    // Values published after this snapshot show once their key's next message arrives
+    ValueSnapshot snap;
+    current.store.snapshot(snap);
+    next->store.seed(snap);
+    return next;
+}
+
+std::unique_ptr<ExtractionTables> ExtractionEngine::install(std::unique_ptr<ExtractionTables> next) {
+    std::unique_ptr<ExtractionTables> previous = std::move(m_current);
+    m_current = std::move(next);
+    m_tables.store(m_current.get(), std::memory_order_release);
+    m_generation.store(m_current->generation, std::memory_order_release);
+    return previous;
+}
+
+std::vector<uint32_t> ExtractionTables::groupsOf(const std::vector<uint32_t>& fieldIds) const {
+    std::vector<uint32_t> groups;
+    const auto& fieldGroups = plan.fieldGroups();
+    if (fieldIds.empty()) {
+        for (uint32_t g = 0; g < plan.groupCount(); ++g) groups.push_back(g);
+        return groups;
     }
+    for (uint32_t id : fieldIds)
+        if (id < fieldGroups.size() && fieldGroups[id] != kNoGroup) groups.push_back(fieldGroups[id]);
+    std::sort(groups.begin(), groups.end());
+    groups.erase(std::unique(groups.begin(), groups.end()), groups.end());
+    return groups;
+}
+
+namespace {
+
+size_t extractWith(ExtractionTables& t, size_t key, const DecodeSlot& slot, const ParsedMessage& msg,
+                   FieldValue* out, size_t capacity) {
+    size_t available = msg.data.size();
+    size_t n = 0;
+    if (t.generated && capacity >= slot.count) {
+        n = t.generated->decode(key, msg.data.data(), available, msg.timestamp, out);
+        t.store.publish(slot.group, out, n);
+        return n;
+    }
+    const DecodeOp* op = t.plan.ops() + slot.first;
+    const DecodeOp* end = op + slot.count;
+    for (; op != end && n < capacity; ++op) {
+        if (op->minWords > available) continue; // bounds check
+        out[n++] = FieldValue{op->fieldId, decodeField(*op, msg.data.data()), msg.timestamp};
+    }
+    t.store.publish(slot.group, out, n);
+    return n;
+}
+
+} // namespace
+
+size_t ExtractionEngine::extract(const ParsedMessage& msg, FieldValue* out, size_t capacity) {
+    if (!msgKeyInRange(msg.rt, msg.sa)) return 0;
+    ExtractionTables& t = *m_tables.load(std::memory_order_acquire);
+    const size_t key = msgKeyIndex(msg.rt, msg.sa, msg.transmit);
+    const DecodeSlot& slot = t.plan.slot(key);
+    if (slot.count == 0) return 0;
+    return extractWith(t, key, slot, msg, out, capacity);
+}
+
+size_t ExtractionEngine::extract(const ParsedMessage& msg, std::vector<FieldValue>& out) {
+    if (!msgKeyInRange(msg.rt, msg.sa)) return 0;
+    ExtractionTables& t = *m_tables.load(std::memory_order_acquire);
+    const size_t key = msgKeyIndex(msg.rt, msg.sa, msg.transmit);
+    const DecodeSlot& slot = t.plan.slot(key);
+    if (slot.count == 0) return 0;
+    if (out.size() < slot.count) out.resize(t.plan.maxOpsPerKey());
+    return extractWith(t, key, slot, msg, out.data(), out.size());
 }
 
 std::vector<ExtractedValue> ExtractionEngine::process(const ParsedMessage& msg) {
-    MsgKey k{msg.rt, msg.sa, msg.transmit};
+    std::vector<FieldValue> values(maxValuesPerMessage());
+    size_t n = extract(msg, values.data(), values.size());
     std::vector<ExtractedValue> out;
-    auto it = m_lookup.find(k);
-    if (it == m_lookup.end()) return out;
-
-    for (const auto& spec : it->second) {
-        // Bounds check
-        int available = static_cast<int>(msg.data.size());
-        if (spec.startWord < 1 || spec.endWord < 1 || spec.startWord > available || spec.endWord > available)
-            continue;
-        uint64_t timestamp = msg.timestamp;
-        double value = 0.0;
-        if (spec.singleBit) {
-            int wIndex = spec.startWord - 1;
-            uint16_t word = msg.data[wIndex];
-            if (spec.bit >=0 && spec.bit < 16) {
-                value = ((word >> spec.bit) & 0x1);
-            }
-        } else if (spec.startWord == spec.endWord) {
-            uint16_t word = msg.data[spec.startWord - 1];
-            if (spec.type == "signed") {
-                int16_t s = static_cast<int16_t>(word);
-                value = static_cast<double>(s);
-            } else {
-                value = word;
-            }
-        } else { // multi-word combine, first word is MSW per user spec
-            // Combine sequential 16-bit words big-endian style (word order: W1 W2 -> (W1<<16)|W2)
-            uint64_t accum = 0;
-            int n = spec.endWord - spec.startWord + 1;
-            for (int i=0;i<n;i++) {
-                uint16_t w = msg.data[spec.startWord - 1 + i];
-                accum = (accum << 16) | w;
-            }
-            if (spec.type == "ieee754" && ( ( (spec.endWord - spec.startWord +1) *16)==32 )) {
-                uint32_t raw = static_cast<uint32_t>(accum & 0xFFFFFFFFu);
-                float f; std::memcpy(&f, &raw, sizeof(f));
-                value = static_cast<double>(f);
-            } else if (spec.type == "signed") {
-                // Signed combine (assume total bits <= 48). Sign bit at MSW highest bit.
-                int totalBits = n * 16;
-                uint64_t signMask = 1ull << (totalBits - 1);
-                int64_t signedVal = (accum & signMask) ? (static_cast<int64_t>(accum) - (1ll << totalBits)) : static_cast<int64_t>(accum);
-                value = static_cast<double>(signedVal);
-            } else {
-                value = static_cast<double>(accum);
-            }
-        }
-        value *= spec.lsbScale; // apply scaling
-        // Type conversions (basic)
-        if (spec.type == "float") {
-            // Interpret raw combined integer as signed? For now treat value already scaled.
-        }
-        ExtractedValue ev{spec.name, value, spec.type, timestamp};
-        out.push_back(ev);
-        std::lock_guard<std::mutex> lk(m_mtx);
-        m_latest[spec.name] = ev;
+    out.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        const FieldSpec& spec = field(values[i].fieldId);
+        out.push_back(ExtractedValue{spec.name, values[i].value, spec.type, values[i].timestamp});
     }
     return out;
 }
@@ -99,18 +146,16 @@ static void setNestedValue(nlohmann::json& root, const std::string& path, double
 
 nlohmann::json ExtractionEngine::buildJsonSnapshot() {
     nlohmann::json j;
-    uint64_t latestTs = 0;
-    {
-        std::lock_guard<std::mutex> lk(m_mtx);
-        for (auto& kv : m_latest) {
-            const auto& name = kv.first;
-            const auto& ev = kv.second;
-            if (ev.timestamp > latestTs) latestTs = ev.timestamp;
-            if (name.find('.') != std::string::npos) {
-                setNestedValue(j, name, ev.numericValue);
-            } else {
-                j[name] = ev.numericValue;
-            }
+    ValueSnapshot snap;
+    snapshot(snap);
+    uint64_t latestTs = snap.latestTimestamp;
+    for (size_t id = 0; id < snap.values.size(); ++id) {
+        if (!snap.valid[id]) continue;
+        const auto& name = fieldName(static_cast<uint32_t>(id));
+        if (name.find('.') != std::string::npos) {
+            setNestedValue(j, name, snap.values[id]);
+        } else {
+            j[name] = snap.values[id];
         }
     }
     // Add timestamps: microseconds and seconds float
@@ -0,0 +1,179 @@
+#include "ExtractionPlan.hpp"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace ddc {
+
+DecodeOp ExtractionPlan::compile(const FieldSpec& f, uint32_t fieldId, bool& valid) {
+    DecodeOp op;
+    op.fieldId = fieldId;
+    op.scale = f.lsbScale;
+    // Fields outside a 32-word payload (or with a non-positive index) can never be in bounds.
+    int lastWord = std::max(f.startWord, f.endWord);
+    valid = f.startWord >= 1 && f.endWord >= 1 && lastWord <= 32 && msgKeyInRange(f.rt, f.subAddress);
+    if (!valid) return op;
+    op.wordOffset = static_cast<uint8_t>(f.startWord - 1);
+    op.minWords = static_cast<uint8_t>(lastWord);
+    int n = f.endWord - f.startWord + 1;
+    if (f.singleBit) {
+        op.op = DecodeOpCode::Bit;
+        // Out-of-range bit index always decodes to 0
+        bool bitOk = f.bit >= 0 && f.bit < 16;
+        op.shift = static_cast<uint8_t>(bitOk ? f.bit : 0);
+        op.mask = bitOk ? 0x1 : 0x0;
+    } else if (n == 1) {
+        op.op = (f.type == "signed") ? DecodeOpCode::Signed16 : DecodeOpCode::Unsigned16;
+    } else if (f.type == "ieee754" && n == 2) {
+        op.op = DecodeOpCode::Ieee754;
+    } else {
+        // Reversed word ranges combine zero words and decode to 0
+        op.wordCount = static_cast<uint8_t>(std::max(n, 0));
+        int bits = std::min(op.wordCount * 16, 64);
+        op.mask = (bits >= 64) ? ~0ull : ((1ull << bits) - 1);
+        if (f.type == "signed" && bits > 0) {
+            op.op = DecodeOpCode::SignedN;
+            op.signBit = 1ull << (bits - 1);
+        } else {
+            op.op = DecodeOpCode::UnsignedN;
+        }
+    }
+    return op;
+}
+
+ExtractionPlan::ExtractionPlan(const AppConfig& cfg, const ExtractionPlan* previous) {
+    // Previous ids stay retired unless a field of the same name claims them
+    std::unordered_multimap<std::string, uint32_t> previousIds;
+    if (previous) {
+        m_fields = previous->m_fields;
+        m_retired.assign(m_fields.size(), 1);
+        for (uint32_t id = 0; id < m_fields.size(); ++id) previousIds.emplace(m_fields[id].name, id);
+    }
+    for (const auto& stream : cfg.streams) {
+        m_streamFields.emplace_back();
+        for (const auto& f : stream.fields) {
+            uint32_t id = static_cast<uint32_t>(m_fields.size());
+            auto it = previousIds.find(f.name);
+            if (it != previousIds.end()) {
+                id = it->second;
+                previousIds.erase(it);
+                m_fields[id] = f;
+                m_retired[id] = 0;
+            } else {
+                m_fields.push_back(f);
+                m_retired.push_back(0);
+            }
+            m_streamFields.back().push_back(id);
+        }
+    }
+
+    // Bucket ops by key, preserving config order within a key
+    std::vector<std::vector<DecodeOp>> buckets(kMsgKeySpace);
+    for (size_t id = 0; id < m_fields.size(); ++id) {
+        const auto& f = m_fields[id];
+        if (m_retired[id]) continue;
+        bool valid = false;
+        DecodeOp op = compile(f, static_cast<uint32_t>(id), valid);
+        if (!valid) continue;
+        buckets[msgKeyIndex(f.rt, f.subAddress, f.transmit)].push_back(op);
+    }
+    m_fieldGroups.assign(m_fields.size(), kNoGroup);
+    for (size_t k = 0; k < kMsgKeySpace; ++k) {
+        auto& b = buckets[k];
+        m_slots[k].first = static_cast<uint32_t>(m_ops.size());
+        m_slots[k].count = static_cast<uint32_t>(b.size());
+        m_slots[k].group = b.empty() ? kNoGroup : static_cast<uint32_t>(m_groupCount++);
+        for (auto& op : b) m_fieldGroups[op.fieldId] = m_slots[k].group;
+        m_ops.insert(m_ops.end(), b.begin(), b.end());
+        m_maxOpsPerKey = std::max(m_maxOpsPerKey, b.size());
+    }
+}
+
+uint64_t ExtractionPlan::signature() const {
+    // FNV-1a
+    uint64_t h = 0xcbf29ce484222325ull;
+    auto mix = [&h](uint64_t v) {
+        for (int i = 0; i < 8; ++i) { h ^= (v >> (i * 8)) & 0xFF; h *= 0x100000001b3ull; }
+    };
+    for (size_t id = 0; id < m_fields.size(); ++id) {
+        for (char c : m_fields[id].name) mix(static_cast<uint8_t>(c));
+        mix(m_retired[id]);
+    }
+    for (size_t k = 0; k < kMsgKeySpace; ++k) {
+        if (m_slots[k].count == 0) continue;
+        mix(k);
+        for (const DecodeOp* op = ops() + m_slots[k].first; op != ops() + m_slots[k].first + m_slots[k].count; ++op) {
+            uint64_t scale; std::memcpy(&scale, &op->scale, sizeof(scale));
+            mix(static_cast<uint64_t>(op->op) | op->wordOffset << 8 | op->wordCount << 16 | op->shift << 24 |
+                static_cast<uint64_t>(op->minWords) << 32);
+            mix(op->fieldId);
+            mix(op->mask);
+            mix(op->signBit);
+            mix(scale);
+        }
+    }
+    return h;
+}
+
+void encodeFieldRaw(const DecodeOp& op, uint64_t raw, uint16_t* words) {
+    uint16_t* w = words + op.wordOffset;
+    switch (op.op) {
+    case DecodeOpCode::Bit:
+        if (op.mask) w[0] = static_cast<uint16_t>((w[0] & ~(1u << op.shift)) | ((raw & 0x1) << op.shift));
+        return;
+    case DecodeOpCode::Unsigned16:
+    case DecodeOpCode::Signed16:
+        w[0] = static_cast<uint16_t>(raw);
+        return;
+    case DecodeOpCode::Ieee754: {
+        float f = static_cast<float>(raw);
+        uint32_t bits; std::memcpy(&bits, &f, sizeof(bits));
+        w[0] = static_cast<uint16_t>(bits >> 16);
+        w[1] = static_cast<uint16_t>(bits);
+        return;
+    }
+    default: break;
+    }
+    // Words beyond the last 64 bits are shifted out by the decoder; zero them
+    raw &= op.mask;
+    for (int i = op.wordCount - 1; i >= 0; --i) { w[i] = static_cast<uint16_t>(raw); raw >>= 16; }
+}
+
+void encodeField(const DecodeOp& op, double value, uint16_t* words) {
+    double r = (op.scale != 0.0) ? std::nearbyint(value / op.scale) : 0.0;
+    if (r != r) r = 0.0;
+    switch (op.op) {
+    case DecodeOpCode::Bit:
+        encodeFieldRaw(op, r != 0.0 ? 1 : 0, words);
+        return;
+    case DecodeOpCode::Unsigned16:
+        encodeFieldRaw(op, static_cast<uint64_t>(std::clamp(r, 0.0, 65535.0)), words);
+        return;
+    case DecodeOpCode::Signed16:
+        encodeFieldRaw(op, static_cast<uint64_t>(static_cast<int64_t>(std::clamp(r, -32768.0, 32767.0))), words);
+        return;
+    case DecodeOpCode::Ieee754: {
+        uint16_t* w = words + op.wordOffset;
+        float f = static_cast<float>(op.scale != 0.0 ? value / op.scale : 0.0);
+        uint32_t bits; std::memcpy(&bits, &f, sizeof(bits));
+        w[0] = static_cast<uint16_t>(bits >> 16);
+        w[1] = static_cast<uint16_t>(bits);
+        return;
+    }
+    default: break;
+    }
+    if (op.wordCount == 0) return;
+    int bits = std::min(op.wordCount * 16, 64);
+    if (op.op == DecodeOpCode::SignedN) {
+        double hi = std::ldexp(1.0, bits - 1);
+        if (r >= hi) encodeFieldRaw(op, op.signBit - 1, words);
+        else if (r < -hi) encodeFieldRaw(op, op.signBit, words);
+        else encodeFieldRaw(op, static_cast<uint64_t>(static_cast<int64_t>(r)), words);
+    } else {
+        double hi = std::ldexp(1.0, bits);
+        if (r >= hi) encodeFieldRaw(op, op.mask, words);
+        else encodeFieldRaw(op, r > 0.0 ? static_cast<uint64_t>(r) : 0, words);
+    }
+}
+
+} // namespace ddc
@@ -0,0 +1,183 @@
+#include "ExtractionPool.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace ddc {
+
+namespace {
+
+// Same idle strategy as the processing thread: yield briefly, then sleep
+void backoff(int& idleSpins) {
+    if (++idleSpins < 64) std::this_thread::yield();
+    else std::this_thread::sleep_for(std::chrono::microseconds(100));
+}
+
+} // namespace
+
+ExtractionPool::ExtractionPool(ExtractionEngine& engine, size_t workers, size_t queueCapacity, bool forwardValues)
+    : m_engine(engine), m_forward(forwardValues) {
+    workers = std::clamp<size_t>(workers, 1, 64);
+    for (size_t i = 0; i < workers; ++i) m_workers.push_back(std::make_unique<Worker>(queueCapacity));
+    m_owner.fill(kNoWorker);
+    m_load.assign(workers, 0);
+    m_generation = engine.generation();
+    assignKeys(engine.plan());
+}
+
+// Heaviest keys first, each to the least loaded worker (by decode ops). Keys that already
+// have an owner keep it: after a reload their messages may still be queued there.
+void ExtractionPool::assignKeys(const ExtractionPlan& plan) {
+    std::vector<size_t> keys;
+    for (size_t k = 0; k < kMsgKeySpace; ++k)
+        if (plan.slot(k).count && m_owner[k] == kNoWorker) keys.push_back(k);
+    std::stable_sort(keys.begin(), keys.end(), [&](size_t a, size_t b) { return plan.slot(a).count > plan.slot(b).count; });
+    for (size_t k : keys) {
+        size_t w = static_cast<size_t>(std::min_element(m_load.begin(), m_load.end()) - m_load.begin());
+        m_owner[k] = static_cast<uint16_t>(w);
+        m_load[w] += plan.slot(k).count;
+    }
+}
+
+ExtractionPool::~ExtractionPool() { stop(); }
+
+void ExtractionPool::setLatency(LatencyStats* stats) {
+    for (size_t i = 0; i < m_workers.size(); ++i)
+        m_workers[i]->latency = stats ? stats->addShard("worker " + std::to_string(i)) : nullptr;
+}
+
+void ExtractionPool::setMetrics(Metrics* metrics) {
+    for (auto& w : m_workers) w->metrics = metrics ? metrics->addShard() : nullptr;
+}
+
+void ExtractionPool::start(ValueSink onValues, IdleHook onIdle) {
+    if (m_running) return;
+    m_onValues = std::move(onValues);
+    m_onIdle = std::move(onIdle);
+    m_stopWorkers = false;
+    m_stopGather = false;
+    for (auto& w : m_workers) {
+        Worker* worker = w.get();
+        worker->reader = m_engine.rcu().addReader();
+        w->thread = std::thread([this, worker] { runWorker(*worker); });
+    }
+    m_gatherReader = m_engine.rcu().addReader();
+    m_gather = std::thread([this] { runGather(); });
+    m_running = true;
+}
+
+bool ExtractionPool::dispatch(const Raw1553Message& raw) {
+    if (!msgKeyInRange(raw.rtAddress, raw.subAddress)) return false;
+    if (m_engine.generation() != m_generation) {
+        // Reload: keys new to the config get an owner (on this thread, which owns m_owner)
+        m_generation = m_engine.generation();
+        assignKeys(m_engine.plan());
+    }
+    uint16_t owner = m_owner[msgKeyIndex(raw.rtAddress, raw.subAddress, raw.tx)];
+    if (owner == kNoWorker) return false;
+    return m_workers[owner]->input.push(raw);
+}
+
+void ExtractionPool::stop() {
+    if (!m_running) return;
+    // Workers first so everything they forward reaches the gather thread
+    m_stopWorkers = true;
+    for (auto& w : m_workers) if (w->thread.joinable()) w->thread.join();
+    m_stopGather = true;
+    if (m_gather.joinable()) m_gather.join();
+    m_running = false;
+}
+
+uint64_t ExtractionPool::processedTotal() const {
+    uint64_t total = 0;
+    for (size_t i = 0; i < m_workers.size(); ++i) total += processed(i);
+    return total;
+}
+
+void ExtractionPool::runWorker(Worker& w) {
+    MessageParser parser;
+    ParsedMessage p;
+    std::vector<FieldValue> values(std::max<size_t>(m_engine.maxValuesPerMessage(), 1));
+    Raw1553Message raw;
+    Chunk chunk;
+    int idleSpins = 0;
+    w.reader->online();
+    for (;; w.reader->quiescent()) {
+        if (w.input.pop(raw)) {
+            idleSpins = 0;
+            size_t n = 0;
+            bool parsed;
+            if (w.latency) {
+                uint64_t t = w.latency->since(LatencyStage::Queue, raw.hostTimeNs);
+                const bool timed = w.latency->sample();
+                parsed = parser.parse(raw, p);
+                if (parsed) {
+                    if (timed) t = w.latency->since(LatencyStage::Parse, t);
+                    n = m_engine.extract(p, values);
+                    if (timed) w.latency->since(LatencyStage::Extract, t);
+                }
+            } else if ((parsed = parser.parse(raw, p))) {
+                n = m_engine.extract(p, values);
+            }
+            if (w.metrics) {
+                if (!parsed) w.metrics->add(Counter::ParseErrors);
+                else {
+                    size_t key = msgKeyIndex(raw.rtAddress, raw.subAddress, raw.tx);
+                    w.metrics->message(key, m_engine.plan().slot(key).count, n);
+                }
+            }
+            // Split into chunks; the gather thread reassembles the message
+            for (size_t done = 0; m_forward && done < n;) {
+                size_t k = std::min(n - done, kChunkValues);
+                std::copy(values.begin() + static_cast<std::ptrdiff_t>(done),
+                          values.begin() + static_cast<std::ptrdiff_t>(done + k), chunk.values);
+                chunk.count = static_cast<uint32_t>(k);
+                chunk.captureNs = raw.hostTimeNs;
+                done += k;
+                chunk.endOfMessage = done == n;
+                w.output.push(chunk);
+            }
+            singleWriterAdd(w.processed, 1);
+            continue;
+        }
+        if (m_stopWorkers.load()) {
+            if (w.input.size() != 0) continue; // pushed just before stop()
+            break;
+        }
+        backoff(idleSpins);
+    }
+    w.reader->offline();
+}
+
+void ExtractionPool::runGather() {
+    std::vector<std::vector<FieldValue>> pending(m_workers.size());
+    for (auto& p : pending) p.reserve(m_engine.maxValuesPerMessage());
+    Chunk chunk;
+    int idleSpins = 0;
+    m_gatherReader->online();
+    for (;; m_gatherReader->quiescent()) {
+        bool any = false;
+        for (size_t i = 0; i < m_workers.size(); ++i) {
+            // Bounded per visit so one busy worker cannot starve the others
+            for (int k = 0; k < 64 && m_workers[i]->output.pop(chunk); ++k) {
+                any = true;
+                auto& values = pending[i];
+                values.insert(values.end(), chunk.values, chunk.values + chunk.count);
+                if (!chunk.endOfMessage) continue;
+                if (m_onValues) m_onValues(values.data(), values.size(), chunk.captureNs);
+                values.clear();
+            }
+        }
+        if (any) { idleSpins = 0; continue; }
+        if (idleSpins == 0 && m_onIdle) m_onIdle();
+        if (m_stopGather.load()) {
+            bool empty = true;
+            for (auto& w : m_workers) empty = empty && w->output.size() == 0;
+            if (empty) break;
+            continue;
+        }
+        backoff(idleSpins);
+    }
+    m_gatherReader->offline();
+}
+
+} // namespace ddc
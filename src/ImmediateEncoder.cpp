@@ -0,0 +1,80 @@
+#include "ImmediateEncoder.hpp"
+#include <map>
+#include <nlohmann/json.hpp>
+
+namespace ddc {
+
+ImmediateEncoder::ImmediateEncoder(const std::vector<std::string>& fieldNames) {
+    m_layouts.resize(fieldNames.size());
+    for (size_t id = 0; id < fieldNames.size(); ++id) {
+        const std::string& name = fieldNames[id];
+        Layout& l = m_layouts[id];
+        auto addSlot = [&l](Slot s) {
+            l.offset[l.slotCount] = static_cast<uint32_t>(l.text.size());
+            l.slot[l.slotCount++] = s;
+        };
+        // Split the dotted name; the field is written after the metadata, so a
+        // top-level segment equal to a metadata key replaces that key.
+        std::vector<std::string> segments;
+        size_t start = 0;
+        while (true) {
+            size_t dot = name.find('.', start);
+            segments.push_back(name.substr(start, dot == std::string::npos ? std::string::npos : dot - start));
+            if (dot == std::string::npos) break;
+            start = dot + 1;
+        }
+        std::map<std::string, int> top{{"timestamp_us", 0}, {"timestamp", 1}, {"datetime", 2}, {"seq", 3}};
+        top[segments.front()] = -1;
+
+        l.text.push_back('{');
+        bool first = true;
+        for (const auto& kv : top) {
+            if (!first) l.text.push_back(',');
+            first = false;
+            l.text += nlohmann::json(kv.first).dump();
+            l.text.push_back(':');
+            switch (kv.second) {
+            case 0: addSlot(Slot::TimestampUs); break;
+            case 1: addSlot(Slot::Timestamp); break;
+            case 2:
+                l.text.push_back('"');
+                addSlot(Slot::Datetime);
+                l.text.push_back('"');
+                break;
+            case 3: addSlot(Slot::Seq); break;
+            default:
+                for (size_t s = 1; s < segments.size(); ++s) {
+                    l.text.push_back('{');
+                    l.text += nlohmann::json(segments[s]).dump();
+                    l.text.push_back(':');
+                }
+                addSlot(Slot::Value);
+                l.text.append(segments.size() - 1, '}');
+                break;
+            }
+        }
+        l.text.push_back('}');
+    }
+}
+
+void ImmediateEncoder::encode(const FieldValue& v, uint64_t seq, std::string& out) {
+    out.clear();
+    if (v.fieldId >= m_layouts.size()) return;
+    const Layout& l = m_layouts[v.fieldId];
+    const char* text = l.text.data();
+    uint32_t pos = 0;
+    for (uint8_t i = 0; i < l.slotCount; ++i) {
+        out.append(text + pos, l.offset[i] - pos);
+        pos = l.offset[i];
+        switch (l.slot[i]) {
+        case Slot::Value: JsonFormatter::appendDouble(out, v.value); break;
+        case Slot::TimestampUs: JsonFormatter::appendUnsigned(out, v.timestamp); break;
+        case Slot::Timestamp: JsonFormatter::appendDouble(out, static_cast<double>(v.timestamp) / 1e6); break;
+        case Slot::Datetime: out.append(m_clock.now(), IsoSecondClock::kLength); break;
+        case Slot::Seq: JsonFormatter::appendUnsigned(out, seq); break;
+        }
+    }
+    out.append(text + pos, l.text.size() - pos);
+}
+
+} // namespace ddc
@@ -1 +1,46 @@
 #include "JsonFormatter.hpp"
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace ddc {
+
+void JsonFormatter::appendDouble(std::string& out, double v) {
+    // Same rules as nlohmann's serializer: non-finite -> null, otherwise its Grisu2
+    // shortest round-trip formatting (std::to_chars can pick different digits).
+    if (!std::isfinite(v)) { out.append("null", 4); return; }
+    std::array<char, 64> buf;
+    char* end = nlohmann::detail::to_chars(buf.data(), buf.data() + buf.size(), v);
+    out.append(buf.data(), static_cast<size_t>(end - buf.data()));
+}
+
+void JsonFormatter::appendUnsigned(std::string& out, uint64_t v) {
+    std::array<char, 24> buf;
+    auto res = std::to_chars(buf.data(), buf.data() + buf.size(), v);
+    out.append(buf.data(), static_cast<size_t>(res.ptr - buf.data()));
+}
+
+const char* IsoSecondClock::now() {
+    std::time_t t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    if (t != m_second) {
+        std::tm tm{};
+#if defined(_WIN32) && !defined(__MINGW32__)
+        gmtime_s(&tm, &t);
+#elif defined(_WIN32)
+        tm = *std::gmtime(&t); // msvcrt keeps this buffer per thread
+#else
+        gmtime_r(&t, &tm);
+#endif
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d:%02dZ",
+                      tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+        std::memcpy(m_text, buf, kLength);
+        m_second = t;
+    }
+    return m_text;
+}
+
+} // namespace ddc
@@ -0,0 +1,116 @@
+#include "LatencyStats.hpp"
+#include <algorithm>
+#include <sstream>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace ddc {
+
+namespace {
+
+unsigned highestBit(uint64_t v) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, v);
+    return static_cast<unsigned>(index);
+#else
+    return 63u - static_cast<unsigned>(__builtin_clzll(v));
+#endif
+}
+
+} // namespace
+
+const char* latencyStageName(LatencyStage stage) {
+    switch (stage) {
+    case LatencyStage::Queue: return "queue";
+    case LatencyStage::Parse: return "parse";
+    case LatencyStage::Extract: return "extract";
+    case LatencyStage::Encode: return "encode";
+    case LatencyStage::Send: return "send";
+    case LatencyStage::EndToEnd: return "end_to_end";
+    }
+    return "?";
+}
+
+size_t LatencyHistogram::bucketOf(uint64_t ns) {
+    if (ns < kSubCount) return static_cast<size_t>(ns);
+    unsigned exponent = highestBit(ns);
+    if (exponent > kMaxExponent) return kBucketCount - 1;
+    uint64_t sub = (ns >> (exponent - kSubBits)) - kSubCount;
+    return static_cast<size_t>((exponent - kSubBits + 1) * kSubCount + sub);
+}
+
+double LatencyHistogram::bucketValue(size_t bucket) {
+    if (bucket < kSubCount) return static_cast<double>(bucket);
+    unsigned exponent = static_cast<unsigned>(bucket / kSubCount) + kSubBits - 1;
+    uint64_t sub = bucket % kSubCount;
+    double width = static_cast<double>(1ull << (exponent - kSubBits));
+    return static_cast<double>(kSubCount + sub) * width + width / 2;
+}
+
+void LatencyHistogram::mergeInto(std::vector<uint64_t>& counts, uint64_t& total, uint64_t& sumNs, uint64_t& maxNs) const {
+    for (size_t b = 0; b < kBucketCount; ++b) counts[b] += m_counts[b].load(std::memory_order_relaxed);
+    total += m_total.load(std::memory_order_relaxed);
+    sumNs += m_sumNs.load(std::memory_order_relaxed);
+    maxNs = std::max(maxNs, m_maxNs.load(std::memory_order_relaxed));
+}
+
+LatencyStats::Shard* LatencyStats::addShard(const std::string& name) {
+    std::lock_guard<std::mutex> lk(m_mtx);
+    m_shards.push_back(std::make_unique<Shard>());
+    m_names.push_back(name);
+    return m_shards.back().get();
+}
+
+size_t LatencyStats::shardCount() const {
+    std::lock_guard<std::mutex> lk(m_mtx);
+    return m_shards.size();
+}
+
+LatencySummary LatencyStats::summary(LatencyStage stage) const {
+    std::vector<uint64_t> counts(LatencyHistogram::kBucketCount, 0);
+    uint64_t total = 0, sumNs = 0, maxNs = 0;
+    {
+        std::lock_guard<std::mutex> lk(m_mtx);
+        for (const auto& shard : m_shards) shard->stage(stage).mergeInto(counts, total, sumNs, maxNs);
+    }
+    LatencySummary s;
+    // Buckets and total are read at slightly different moments; rank against the buckets
+    uint64_t inBuckets = 0;
+    for (uint64_t c : counts) inBuckets += c;
+    s.count = inBuckets;
+    if (inBuckets == 0) return s;
+    s.meanUs = total ? static_cast<double>(sumNs) / static_cast<double>(total) / 1000.0 : 0.0;
+    s.maxUs = static_cast<double>(maxNs) / 1000.0;
+    const double quantiles[] = {0.5, 0.99, 0.999};
+    double* out[] = {&s.p50Us, &s.p99Us, &s.p999Us};
+    for (size_t q = 0; q < 3; ++q) {
+        uint64_t rank = static_cast<uint64_t>(quantiles[q] * static_cast<double>(inBuckets - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t b = 0; b < counts.size(); ++b) {
+            seen += counts[b];
+            if (seen >= rank) {
+                *out[q] = std::min(LatencyHistogram::bucketValue(b) / 1000.0, s.maxUs);
+                break;
+            }
+        }
+    }
+    return s;
+}
+
+std::string LatencyStats::report() const {
+    std::ostringstream os;
+    os.precision(3);
+    os << std::fixed;
+    for (size_t i = 0; i < kLatencyStageCount; ++i) {
+        auto stage = static_cast<LatencyStage>(i);
+        LatencySummary s = summary(stage);
+        if (!s.count) continue;
+        os << latencyStageName(stage) << " n=" << s.count << " p50=" << s.p50Us << "us p99=" << s.p99Us
+           << "us p99.9=" << s.p999Us << "us max=" << s.maxUs << "us\n";
+    }
+    return os.str();
+}
+
+} // namespace ddc
@@ -0,0 +1,166 @@
+#include "LatestValueStore.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace ddc {
+
+LatestValueStore::LatestValueStore(const ExtractionPlan& plan, size_t windows)
+    : m_fieldCount(plan.fields().size()),
+      m_slots(new Slot[plan.fields().size()]),
+      m_groups(new Group[plan.groupCount()]),
+      m_groupCount(plan.groupCount()) {
+    const auto& groups = plan.fieldGroups();
+    m_groupStart.assign(m_groupCount + 1, 0);
+    for (uint32_t g : groups) if (g != kNoGroup) ++m_groupStart[g + 1];
+    for (size_t g = 0; g < m_groupCount; ++g) m_groupStart[g + 1] += m_groupStart[g];
+    m_groupFields.resize(m_groupStart[m_groupCount]);
+    std::vector<uint32_t> fill(m_groupStart.begin(), m_groupStart.end() - 1);
+    for (uint32_t id = 0; id < groups.size(); ++id)
+        if (groups[id] != kNoGroup) m_groupFields[fill[groups[id]]++] = id;
+
+    m_aggIndex.assign(m_fieldCount, kNoAggregate);
+    m_groupAggregated.assign(m_groupCount, 0);
+    for (uint32_t id = 0; id < m_fieldCount; ++id) {
+        Aggregate mode = plan.fields()[id].aggregate;
+        if (mode == Aggregate::Last || groups[id] == kNoGroup) continue;
+        m_aggIndex[id] = static_cast<uint32_t>(m_aggMode.size());
+        m_aggMode.push_back(mode);
+        if (!m_groupAggregated[groups[id]]) m_aggGroups.push_back(groups[id]);
+        m_groupAggregated[groups[id]] = 1;
+    }
+    m_aggCount = m_aggMode.size();
+    if (m_aggCount == 0) return;
+    m_windowCount = windows;
+    m_epochs.reset(new std::atomic<uint64_t>[windows]);
+    for (size_t w = 0; w < windows; ++w) m_epochs[w].store(0, std::memory_order_relaxed);
+    m_accums.reset(new Accum[windows * 2 * m_aggCount]);
+}
+
+void LatestValueStore::publish(uint32_t group, const FieldValue* values, size_t count) {
+    if (group >= m_groupCount || count == 0) return;
+    auto& seq = m_groups[group].seq;
+    uint64_t s = seq.load(std::memory_order_relaxed);
+    seq.store(s + 1, std::memory_order_relaxed);
+    // With windows, the epochs read below must not be ordered before the odd seq: either
+    // closeWindow() sees this write in progress, or this write sees the new epoch.
+    std::atomic_thread_fence(m_windowCount ? std::memory_order_seq_cst : std::memory_order_release);
+    for (size_t i = 0; i < count; ++i) {
+        Slot& slot = m_slots[values[i].fieldId];
+        slot.value.store(values[i].value, std::memory_order_relaxed);
+        slot.timestamp.store(values[i].timestamp, std::memory_order_relaxed);
+        slot.valid.store(1, std::memory_order_relaxed);
+        if (m_windowCount && m_aggIndex[values[i].fieldId] != kNoAggregate)
+            accumulate(m_aggIndex[values[i].fieldId], values[i].value);
+    }
+    seq.store(s + 2, std::memory_order_release);
+}
+
+void LatestValueStore::seed(const ValueSnapshot& from) {
+    for (uint32_t id : m_groupFields) {
+        if (id >= from.valid.size() || !from.valid[id]) continue;
+        m_slots[id].value.store(from.values[id], std::memory_order_relaxed);
+        m_slots[id].timestamp.store(from.timestamps[id], std::memory_order_relaxed);
+        m_slots[id].valid.store(1, std::memory_order_relaxed);
+    }
+}
+
+// Writer side only, inside the group's write section
+void LatestValueStore::accumulate(uint32_t agg, double value) {
+    if (std::isnan(value)) return;
+    for (size_t w = 0; w < m_windowCount; ++w) {
+        uint64_t epoch = m_epochs[w].load(std::memory_order_relaxed);
+        Accum& a = accum(w, epoch, agg);
+        if (a.epoch.load(std::memory_order_relaxed) != epoch) {
+            // First sample of the window: this set was read when the epoch before last closed
+            a.epoch.store(epoch, std::memory_order_relaxed);
+            a.count.store(1, std::memory_order_relaxed);
+            a.sum.store(value, std::memory_order_relaxed);
+            a.sumSq.store(value * value, std::memory_order_relaxed);
+            a.min.store(value, std::memory_order_relaxed);
+            a.max.store(value, std::memory_order_relaxed);
+            continue;
+        }
+        singleWriterAdd(a.count, 1);
+        singleWriterAdd(a.sum, value);
+        singleWriterAdd(a.sumSq, value * value);
+        if (value < a.min.load(std::memory_order_relaxed)) a.min.store(value, std::memory_order_relaxed);
+        if (value > a.max.load(std::memory_order_relaxed)) a.max.store(value, std::memory_order_relaxed);
+    }
+}
+
+// Copies one group consistently; returns its newest valid timestamp
+uint64_t LatestValueStore::readGroup(size_t g, ValueSnapshot& out) const {
+    const auto& seq = m_groups[g].seq;
+    const uint32_t* first = m_groupFields.data() + m_groupStart[g];
+    const uint32_t* last = m_groupFields.data() + m_groupStart[g + 1];
+    for (unsigned attempt = 0;; ++attempt) {
+        uint64_t s1 = seq.load(std::memory_order_acquire);
+        if (s1 & 1) { if (attempt > 64) std::this_thread::yield(); continue; }
+        for (const uint32_t* id = first; id != last; ++id) {
+            const Slot& slot = m_slots[*id];
+            out.values[*id] = slot.value.load(std::memory_order_relaxed);
+            out.timestamps[*id] = slot.timestamp.load(std::memory_order_relaxed);
+            out.valid[*id] = slot.valid.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq.load(std::memory_order_relaxed) == s1) break;
+        if (attempt > 64) std::this_thread::yield();
+    }
+    uint64_t latest = 0;
+    for (const uint32_t* id = first; id != last; ++id)
+        if (out.valid[*id] && out.timestamps[*id] > latest) latest = out.timestamps[*id];
+    return latest;
+}
+
+void LatestValueStore::snapshot(ValueSnapshot& out, const std::vector<uint32_t>* groups) const {
+    if (out.values.size() != m_fieldCount) out.resize(m_fieldCount);
+    uint64_t latest = 0;
+    if (groups) {
+        for (uint32_t g : *groups) if (g < m_groupCount) latest = std::max(latest, readGroup(g, out));
+    } else {
+        for (size_t g = 0; g < m_groupCount; ++g) latest = std::max(latest, readGroup(g, out));
+    }
+    out.latestTimestamp = latest;
+}
+
+void LatestValueStore::closeWindow(size_t window, ValueSnapshot& out, const std::vector<uint32_t>* groups) const {
+    snapshot(out, groups);
+    if (window >= m_windowCount) return;
+    const uint64_t epoch = m_epochs[window].fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fence in publish()
+    for (uint32_t g : groups ? *groups : m_aggGroups) {
+        if (g >= m_groupCount || !m_groupAggregated[g]) continue;
+        const auto& seq = m_groups[g].seq;
+        const uint32_t* first = m_groupFields.data() + m_groupStart[g];
+        const uint32_t* last = m_groupFields.data() + m_groupStart[g + 1];
+        for (unsigned attempt = 0;; ++attempt) {
+            uint64_t s1 = seq.load(std::memory_order_acquire);
+            if (s1 & 1) { if (attempt > 64) std::this_thread::yield(); continue; }
+            for (const uint32_t* id = first; id != last; ++id) {
+                uint32_t agg = m_aggIndex[*id];
+                if (agg == kNoAggregate) continue;
+                const Accum& a = accum(window, epoch, agg);
+                uint64_t n = a.epoch.load(std::memory_order_relaxed) == epoch ? a.count.load(std::memory_order_relaxed) : 0;
+                double v = m_slots[*id].value.load(std::memory_order_relaxed);
+                switch (m_aggMode[agg]) {
+                case Aggregate::Count: v = static_cast<double>(n); break;
+                case Aggregate::Min: if (n) v = a.min.load(std::memory_order_relaxed); break;
+                case Aggregate::Max: if (n) v = a.max.load(std::memory_order_relaxed); break;
+                case Aggregate::Mean: if (n) v = a.sum.load(std::memory_order_relaxed) / static_cast<double>(n); break;
+                case Aggregate::Rms:
+                    if (n) v = std::sqrt(a.sumSq.load(std::memory_order_relaxed) / static_cast<double>(n));
+                    else v = std::fabs(v);
+                    break;
+                default: break;
+                }
+                out.values[*id] = v;
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == s1) break;
+            if (attempt > 64) std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace ddc
@@ -20,9 +20,9 @@ public:
 
     void run() {
         monitor.start([this](const Raw1553Message& raw){
-            auto parsed = parser.parse(raw);
-            if (!parsed) return;
-            auto json = parser.toJson(*parsed);
+            ParsedMessage parsed;
+            if (!parser.parse(raw, parsed)) return;
+            auto json = parser.toJson(parsed);
             auto payload = JsonFormatter::compact(json);
             udp.send(payload);
 #ifdef DDC_ENABLE_LOGGING
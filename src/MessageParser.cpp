@@ -3,17 +3,18 @@
 
 namespace ddc {
 
-std::optional<ParsedMessage> MessageParser::parse(const Raw1553Message& raw) const {
-    ParsedMessage p;
-    p.rt = raw.rtAddress;
-    p.sa = raw.subAddress;
-    p.wc = raw.wordCount;
-    p.modeCode = raw.isModeCode;
-    p.transmit = raw.tx;
-    p.channel = raw.channel;
-    p.timestamp = raw.timestamp;
-    p.data = raw.dataWords;
-    return p;
+bool MessageParser::parse(const Raw1553Message& raw, ParsedMessage& out) const {
+    if (raw.dataWordCount > kMax1553DataWords) return false;
+    out.rt = raw.rtAddress;
+    out.sa = raw.subAddress;
+    out.wc = raw.wordCount;
+    out.modeCode = raw.isModeCode;
+    out.transmit = raw.tx;
+    out.channel = raw.channel;
+    out.bus = raw.bus;
+    out.timestamp = raw.timestamp;
+    out.data = WordSpan{raw.dataWords.data(), raw.dataWordCount};
+    return true;
 }
 
 nlohmann::json MessageParser::toJson(const ParsedMessage& msg) const {
@@ -24,6 +25,7 @@ nlohmann::json MessageParser::toJson(const ParsedMessage& msg) const {
     j["modeCode"] = msg.modeCode;
     j["tx"] = msg.transmit;
     j["channel"] = msg.channel;
+    j["bus"] = msg.bus;
     j["timestamp"] = msg.timestamp;
     // Convert data words to hex strings for readability
     std::vector<std::string> dataHex; dataHex.reserve(msg.data.size());
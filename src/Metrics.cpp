@@ -0,0 +1,43 @@
+#include "Metrics.hpp"
+
+namespace ddc {
+
+const char* counterName(Counter c) {
+    switch (c) {
+    case Counter::Captured: return "captured";
+    case Counter::CaptureDropped: return "capture_dropped";
+    case Counter::Processed: return "processed";
+    case Counter::ParseErrors: return "parse_errors";
+    case Counter::Unmatched: return "unmatched";
+    case Counter::Extracted: return "extracted";
+    case Counter::Values: return "values";
+    case Counter::BoundsMisses: return "bounds_misses";
+    }
+    return "?";
+}
+
+Metrics::Shard* Metrics::addShard() {
+    std::lock_guard<std::mutex> lk(m_mtx);
+    m_shards.push_back(std::make_unique<Shard>());
+    return m_shards.back().get();
+}
+
+uint64_t Metrics::total(Counter c) const {
+    std::lock_guard<std::mutex> lk(m_mtx);
+    uint64_t sum = 0;
+    for (const auto& s : m_shards) sum += s->m_counters[static_cast<size_t>(c)].load(std::memory_order_relaxed);
+    return sum;
+}
+
+void Metrics::keyTotals(std::vector<KeyTotals>& out) const {
+    out.assign(kMsgKeySpace, KeyTotals{});
+    std::lock_guard<std::mutex> lk(m_mtx);
+    for (const auto& s : m_shards) {
+        for (size_t k = 0; k < kMsgKeySpace; ++k) {
+            out[k].messages += s->m_keyMessages[k].load(std::memory_order_relaxed);
+            out[k].boundsMisses += s->m_keyBoundsMisses[k].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+} // namespace ddc
@@ -0,0 +1,233 @@
+#include "OutputFanout.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace ddc {
+
+namespace {
+
+constexpr size_t kMaxPendingCaptures = 65536;
+
+std::vector<std::string> namesOf(const ExtractionPlan& plan) {
+    std::vector<std::string> names;
+    for (const auto& f : plan.fields()) names.push_back(f.name);
+    return names;
+}
+
+// Field ids of the named streams, sorted; empty = all, so a selection naming every stream
+// groups with sinks that name none.
+std::vector<uint32_t> fieldIdsOf(const AppConfig& cfg, const ExtractionPlan& plan, const std::vector<std::string>& streams) {
+    std::vector<uint32_t> ids;
+    if (streams.empty()) return ids;
+    for (size_t s = 0; s < cfg.streams.size(); ++s)
+        if (std::find(streams.begin(), streams.end(), cfg.streams[s].name) != streams.end())
+            ids.insert(ids.end(), plan.streamFields()[s].begin(), plan.streamFields()[s].end());
+    std::sort(ids.begin(), ids.end());
+    if (ids.size() == plan.fields().size()) ids.clear();
+    return ids;
+}
+
+} // namespace
+
+OutputFanout::OutputFanout(const AppConfig& cfg, const ExtractionEngine& engine)
+    : m_cfg(cfg),
+      m_engine(engine),
+      m_sinks(cfg.sinks) {
+    for (size_t i = 0; i < m_sinks.size(); ++i) {
+        const SinkConfig& s = m_sinks[i];
+        m_publishers.push_back(std::make_unique<UdpPublisher>());
+        std::vector<uint32_t> ids = fieldIdsOf(cfg, engine.plan(), s.streams);
+        auto same = [&](const Group& g) {
+            return g.batch == s.batch && g.format == s.format && g.fieldIds == ids &&
+                   (!s.batch || g.rateHz == s.rateHz);
+        };
+        auto it = std::find_if(m_groups.begin(), m_groups.end(), [&](const auto& g) { return same(*g); });
+        if (it == m_groups.end()) {
+            auto g = std::make_unique<Group>();
+            g->batch = s.batch;
+            g->format = s.format;
+            g->rateHz = s.rateHz;
+            g->streams = s.streams;
+            g->fieldIds = ids;
+            if (s.batch) addBatchTicks(*g);
+            m_groups.push_back(std::move(g));
+            it = m_groups.end() - 1;
+        }
+        (*it)->sinks.push_back(i);
+        m_hasImmediate = m_hasImmediate || !s.batch;
+        m_hasBinary = m_hasBinary || s.format == OutputFormat::Binary;
+    }
+    m_current = build(engine.tables());
+    m_tables.store(m_current.get(), std::memory_order_release);
+}
+
+OutputFanout::~OutputFanout() { stop(); }
+
+// Splits the group's streams by rate (stream rate_hz, else the sink's), one tick each
+void OutputFanout::addBatchTicks(Group& g) {
+    struct Bucket { double rateHz; std::vector<size_t> streams; std::string name; size_t fields; };
+    std::vector<Bucket> buckets;
+    for (size_t s = 0; s < m_cfg.streams.size(); ++s) {
+        const auto& sc = m_cfg.streams[s];
+        bool selected = g.streams.empty() || std::find(g.streams.begin(), g.streams.end(), sc.name) != g.streams.end();
+        if (!selected || sc.fields.empty()) continue;
+        double rate = sc.rateHz > 0 ? sc.rateHz : g.rateHz;
+        auto b = std::find_if(buckets.begin(), buckets.end(), [&](const Bucket& x) { return x.rateHz == rate; });
+        if (b == buckets.end()) b = buckets.insert(buckets.end(), Bucket{rate, {}, {}, 0});
+        b->streams.push_back(s);
+        b->fields += sc.fields.size();
+        b->name += (b->name.empty() ? "" : ",") + sc.name;
+    }
+    if (buckets.empty()) buckets.push_back({g.rateHz, {}, "all", 0});
+    for (auto& b : buckets) {
+        BatchTick t;
+        t.group = &g;
+        t.rateHz = b.rateHz;
+        if (b.fields == m_engine.fieldCount()) { b.streams.clear(); b.name = "all"; } // empty = every field
+        t.name = b.name;
+        t.window = m_ticks.size();
+        t.streams = b.streams;
+        m_ticks.push_back(std::move(t));
+        m_scheduler.add(b.rateHz);
+    }
+}
+
+// Encoders for one generation of the engine's tables. Stream names and rates are fixed at
+// start, so groups and ticks keep their shape; only their field ids change.
+std::unique_ptr<OutputFanout::Tables> OutputFanout::build(const ExtractionTables& engine) const {
+    const ExtractionPlan& plan = engine.plan;
+    auto t = std::make_unique<Tables>(engine, namesOf(plan));
+    for (const auto& g : m_groups) {
+        std::vector<uint32_t> ids = g->fieldIds.empty() ? g->fieldIds : fieldIdsOf(m_cfg, plan, g->streams);
+        auto& included = t->included.emplace_back(plan.fields().size(), g->fieldIds.empty() ? 1 : 0);
+        for (uint32_t id : ids) included[id] = 1;
+    }
+    for (const auto& tick : m_ticks) {
+        std::vector<uint32_t> ids;
+        for (size_t s : tick.streams) ids.insert(ids.end(), plan.streamFields()[s].begin(), plan.streamFields()[s].end());
+        std::sort(ids.begin(), ids.end());
+        TickTables& tt = t->ticks.emplace_back();
+        tt.groups = engine.groupsOf(ids);
+        if (tick.group->format == OutputFormat::Json) tt.json = std::make_unique<SnapshotSerializer>(t->fieldNames, ids);
+        else tt.binary = std::make_unique<BinaryEncoder>(plan.fields(), ids);
+    }
+    return t;
+}
+
+void OutputFanout::reload(const ExtractionTables& next) {
+    m_retired.push_back(std::move(m_current));
+    m_current = build(next);
+    m_tables.store(m_current.get(), std::memory_order_release);
+    m_schemaChanged = true;
+}
+
+void OutputFanout::freeRetired() { m_retired.clear(); }
+
+bool OutputFanout::open(std::string& err) {
+    for (size_t i = 0; i < m_sinks.size(); ++i) {
+        UdpOptions options;
+        options.sendBufferBytes = m_cfg.udpSendBuffer;
+        options.multicastTtl = m_sinks[i].multicastTtl;
+        options.multicastInterface = m_sinks[i].multicastInterface;
+        if (!m_publishers[i]->open(m_sinks[i].host, sinkPort(i), options)) {
+            err = "cannot open sink " + m_sinks[i].host + ":" + std::to_string(sinkPort(i));
+            return false;
+        }
+    }
+    return true;
+}
+
+void OutputFanout::start() {
+    if (m_running.exchange(true)) return;
+    if (!m_ticks.empty()) {
+        m_batchReader = m_engine.rcu().addReader();
+        m_batchThread = std::thread([this] { m_scheduler.run([this](size_t i) { runBatchTick(i); }, m_running); });
+    }
+    if (m_hasBinary) {
+        m_schemaReader = m_engine.rcu().addReader();
+        m_schemaThread = std::thread([this] { runSchema(); });
+    }
+}
+
+void OutputFanout::setLatency(LatencyStats::Shard* shard) {
+    m_latency = shard;
+    m_pendingCaptures.clear();
+    if (shard) m_pendingCaptures.reserve(kMaxPendingCaptures);
+}
+
+void OutputFanout::publish(const FieldValue* values, size_t count, uint64_t captureNs) {
+    const bool timed = m_latency && m_hasImmediate && count && m_latency->sample();
+    const uint64_t start = timed ? steadyNowNs() : 0;
+    Tables& t = *m_tables.load(std::memory_order_acquire);
+    for (size_t gi = 0; gi < m_groups.size(); ++gi) {
+        Group& g = *m_groups[gi];
+        if (g.batch) continue;
+        const auto& included = t.included[gi];
+        for (size_t i = 0; i < count; ++i) {
+            const FieldValue& v = values[i];
+            if (v.fieldId >= included.size() || !included[v.fieldId]) continue;
+            if (g.format == OutputFormat::Binary) t.binary.encodeValue(v, g.seq++, m_payload);
+            else t.immediate.encode(v, g.seq++, m_payload);
+            for (size_t s : g.sinks) m_publishers[s]->enqueue(m_payload);
+        }
+    }
+    if (!m_latency || !m_hasImmediate || count == 0) return;
+    if (timed) m_latency->since(LatencyStage::Encode, start);
+    // Past the reserve, samples are dropped rather than allocating
+    if (captureNs && m_pendingCaptures.size() < m_pendingCaptures.capacity()) m_pendingCaptures.push_back(captureNs);
+}
+
+void OutputFanout::flush() {
+    const uint64_t start = m_latency && !m_pendingCaptures.empty() ? steadyNowNs() : 0;
+    for (auto& gp : m_groups)
+        if (!gp->batch)
+            for (size_t s : gp->sinks) m_publishers[s]->flush();
+    if (!start) return;
+    const uint64_t sent = m_latency->since(LatencyStage::Send, start);
+    for (uint64_t captureNs : m_pendingCaptures)
+        if (sent >= captureNs) m_latency->record(LatencyStage::EndToEnd, sent - captureNs);
+    m_pendingCaptures.clear();
+}
+
+void OutputFanout::stop() {
+    m_running = false;
+    if (m_batchThread.joinable()) m_batchThread.join();
+    if (m_schemaThread.joinable()) m_schemaThread.join();
+    for (auto& p : m_publishers) p->close();
+}
+
+// Scheduler thread: snapshot of the tick's groups, encoded once for every sink of the group.
+// Online only while ticking, so a reload never waits for the next (possibly slow) tick.
+void OutputFanout::runBatchTick(size_t i) {
+    BatchTick& t = m_ticks[i];
+    m_batchReader->online();
+    const Tables& tables = *m_tables.load(std::memory_order_acquire);
+    const TickTables& tt = tables.ticks[i];
+    tables.engine->store.closeWindow(t.window, t.snap, &tt.groups);
+    Group& g = *t.group;
+    if (tt.binary) tt.binary->encodeSnapshot(t.snap, g.seq++, t.payload);
+    else tt.json->serialize(t.snap, g.seq++, t.payload);
+    m_batchReader->offline();
+    for (size_t s : g.sinks) m_publishers[s]->send(t.payload);
+}
+
+// Binary sinks: announce the id -> name/wire type schema periodically so late joiners can decode
+void OutputFanout::runSchema() {
+    std::vector<std::string> fragments;
+    auto next = std::chrono::steady_clock::now();
+    for (uint64_t announcement = 0; m_running.load(); ++announcement) {
+        m_schemaReader->online();
+        m_tables.load(std::memory_order_acquire)->binary.encodeSchema(announcement, fragments);
+        m_schemaReader->offline();
+        for (size_t i = 0; i < m_sinks.size(); ++i) {
+            if (m_sinks[i].format != OutputFormat::Binary) continue;
+            for (const auto& f : fragments) m_publishers[i]->send(f);
+        }
+        next += std::chrono::milliseconds(m_cfg.schemaIntervalMs);
+        // A reload announces the new schema right away
+        while (m_running.load() && std::chrono::steady_clock::now() < next && !m_schemaChanged.exchange(false))
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+} // namespace ddc
@@ -0,0 +1,65 @@
+#include "RateScheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <thread>
+
+namespace ddc {
+
+size_t RateScheduler::add(double rateHz) {
+    Entry e;
+    e.period = std::chrono::duration<double>(1.0 / rateHz);
+    m_entries.push_back(e);
+    return m_entries.size() - 1;
+}
+
+void RateScheduler::run(const std::function<void(size_t)>& onTick, const std::atomic<bool>& running) {
+    using Due = std::pair<Clock::time_point, size_t>;
+    std::priority_queue<Due, std::vector<Due>, std::greater<Due>> heap;
+    m_start = Clock::now();
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        m_entries[i].tick = 0;
+        heap.push({m_start, i});
+    }
+    while (running.load() && !heap.empty()) {
+        auto [due, i] = heap.top();
+        auto now = Clock::now();
+        if (due > now) {
+            // Short slices so stop() is not held up by a slow entry
+            std::this_thread::sleep_until(std::min(due, now + std::chrono::milliseconds(50)));
+            continue;
+        }
+        heap.pop();
+        Entry& e = m_entries[i];
+        double lateUs = std::chrono::duration<double, std::micro>(now - due).count();
+        e.latenessSumUs += lateUs;
+        e.latenessMaxUs = std::max(e.latenessMaxUs, lateUs);
+        ++e.served;
+        onTick(i);
+
+        ++e.tick;
+        auto next = deadline(e);
+        auto after = Clock::now();
+        if (after >= next + e.period) {
+            // Whole periods went by: skip them instead of catching up in a burst
+            auto behind = std::chrono::duration<double>(after - next) / e.period;
+            auto skip = static_cast<uint64_t>(std::floor(behind));
+            e.tick += skip;
+            e.missed += skip;
+            next = deadline(e);
+        }
+        heap.push({next, i});
+    }
+}
+
+RateScheduler::Stats RateScheduler::stats(size_t entry) const {
+    const Entry& e = m_entries[entry];
+    Stats s;
+    s.ticks = e.served;
+    s.missed = e.missed;
+    s.meanLatenessUs = e.served ? e.latenessSumUs / static_cast<double>(e.served) : 0.0;
+    s.maxLatenessUs = e.latenessMaxUs;
+    return s;
+}
+
+} // namespace ddc
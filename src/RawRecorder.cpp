@@ -0,0 +1,127 @@
+#include "RawRecorder.hpp"
+#include "BinaryFormat.hpp"
+#include <chrono>
+#include <cstring>
+
+namespace ddc {
+
+RawRecorder::RawRecorder() : m_ring(kQueueCapacity, OverflowPolicy::Block) {}
+
+RawRecorder::~RawRecorder() { close(); }
+
+bool RawRecorder::open(const std::string& path, std::string& err) {
+    if (m_file) { err = "recorder already open"; return false; }
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) { err = "cannot create recording " + path; return false; }
+    std::setvbuf(m_file, nullptr, _IONBF, 0); // blocks are already large
+    m_block.clear();
+    m_block.reserve(kBlockBytes + 4096);
+    m_block.resize(kRecordingHeaderSize);
+    uint8_t* h = m_block.data();
+    std::memcpy(h, kRecordingMagic, 8);
+    putLE(h + 8, kRecordingVersion, 2);
+    putLE(h + 10, kRecordingHeaderSize, 2);
+    putLE(h + 12, 0, 4);
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    putLE(h + 16, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now).count()), 8);
+    putLE(h + 24, 0, 8);
+    m_offset = 0;
+    m_indexCount = 0;
+    m_lastIndexOffset = 0;
+    m_stop = false;
+    m_writer = std::thread([this] { run(); });
+    return true;
+}
+
+void RawRecorder::close() {
+    if (!m_file) return;
+    m_stop = true;
+    m_ring.close();
+    if (m_writer.joinable()) m_writer.join();
+    std::fclose(m_file);
+    m_file = nullptr;
+}
+
+void RawRecorder::run() {
+    Raw1553Message msg;
+    auto lastWrite = std::chrono::steady_clock::now();
+    for (;;) {
+        if (m_ring.pop(msg)) { append(msg); continue; }
+        if (m_stop.load()) {
+            if (m_ring.size() != 0) continue; // pushed just before close()
+            break;
+        }
+        // Idle: hand over what we have now and then so a crash loses little
+        auto now = std::chrono::steady_clock::now();
+        if (!m_block.empty() && now - lastWrite > std::chrono::milliseconds(100)) { writeBlock(); lastWrite = now; }
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    // Trailer links to the last index record
+    size_t at = m_block.size();
+    m_block.resize(at + kRecordTrailerSize, 0);
+    uint8_t* t = m_block.data() + at;
+    t[0] = static_cast<uint8_t>(RecordType::Trailer);
+    putLE(t + 4, m_indexCount, 4);
+    putLE(t + 8, m_lastIndexOffset, 8);
+    putLE(t + 16, m_messages.load(), 8);
+    putLE(t + 24, m_firstTs, 8);
+    putLE(t + 32, m_lastTs, 8);
+    writeBlock();
+    std::fflush(m_file);
+}
+
+void RawRecorder::append(const Raw1553Message& msg) {
+    uint64_t count = m_messages.load(std::memory_order_relaxed);
+    if (count == 0 || msg.timestamp - m_lastIndexTs >= kIndexIntervalUs ||
+        count - m_lastIndexOrdinal >= kIndexIntervalMessages)
+        writeIndex(msg.timestamp);
+
+    size_t n = msg.dataWordCount > kMax1553DataWords ? kMax1553DataWords : msg.dataWordCount;
+    size_t at = m_block.size();
+    m_block.resize(at + kRecordMessageHeaderSize + 2 * n);
+    uint8_t* r = m_block.data() + at;
+    r[0] = static_cast<uint8_t>(RecordType::Message);
+    r[1] = static_cast<uint8_t>((msg.tx ? 0x1 : 0) | (msg.isModeCode ? 0x2 : 0) | ((msg.bus & 0x3F) << 2));
+    r[2] = static_cast<uint8_t>(msg.rtAddress);
+    r[3] = static_cast<uint8_t>(msg.subAddress);
+    r[4] = static_cast<uint8_t>(n);
+    r[5] = static_cast<uint8_t>(msg.channel);
+    putLE(r + 6, msg.wordCount, 2);
+    putLE(r + 8, msg.timestamp, 8);
+    putLE(r + 16, msg.statusWord1, 4);
+    putLE(r + 20, msg.statusWord2, 4);
+    uint8_t* w = r + kRecordMessageHeaderSize;
+    for (size_t i = 0; i < n; ++i) {
+        w[2 * i] = static_cast<uint8_t>(msg.dataWords[i]);
+        w[2 * i + 1] = static_cast<uint8_t>(msg.dataWords[i] >> 8);
+    }
+    if (count == 0) m_firstTs = msg.timestamp;
+    m_lastTs = msg.timestamp;
+    m_messages.store(count + 1, std::memory_order_relaxed);
+    if (m_block.size() >= kBlockBytes) writeBlock();
+}
+
+void RawRecorder::writeIndex(uint64_t timestamp) {
+    size_t at = m_block.size();
+    m_block.resize(at + kRecordIndexSize, 0);
+    uint8_t* r = m_block.data() + at;
+    r[0] = static_cast<uint8_t>(RecordType::Index);
+    uint64_t ordinal = m_messages.load(std::memory_order_relaxed);
+    putLE(r + 8, timestamp, 8);
+    putLE(r + 16, ordinal, 8);
+    putLE(r + 24, m_lastIndexOffset, 8);
+    m_lastIndexOffset = m_offset + at;
+    m_lastIndexTs = timestamp;
+    m_lastIndexOrdinal = ordinal;
+    ++m_indexCount;
+}
+
+void RawRecorder::writeBlock() {
+    if (m_block.empty()) return;
+    std::fwrite(m_block.data(), 1, m_block.size(), m_file);
+    m_offset += m_block.size();
+    m_bytes.store(m_offset, std::memory_order_relaxed);
+    m_block.clear();
+}
+
+} // namespace ddc
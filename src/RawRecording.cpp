@@ -0,0 +1,193 @@
+#include "RawRecording.hpp"
+#include "BinaryFormat.hpp"
+#include <algorithm>
+#include <cstring>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ddc {
+
+RawRecordingReader::~RawRecordingReader() { close(); }
+
+bool RawRecordingReader::open(const std::string& path, std::string& err) {
+    close();
+#ifdef _WIN32
+    HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) { err = "cannot open recording " + path; return false; }
+    LARGE_INTEGER size{};
+    ::GetFileSizeEx(file, &size);
+    m_file = file;
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size > 0) {
+        HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) { err = "cannot map recording " + path; close(); return false; }
+        m_mapping = mapping;
+        m_data = static_cast<const uint8_t*>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) { err = "cannot open recording " + path; return false; }
+    struct stat st{};
+    ::fstat(fd, &st);
+    m_size = static_cast<size_t>(st.st_size);
+    if (m_size > 0) {
+        void* p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            m_data = static_cast<const uint8_t*>(p);
+            ::madvise(p, m_size, MADV_SEQUENTIAL);
+        }
+    }
+    ::close(fd);
+#endif
+    if (!m_data || m_size < kRecordingHeaderSize || std::memcmp(m_data, kRecordingMagic, 8) != 0) {
+        err = "not a raw 1553 recording: " + path;
+        close();
+        return false;
+    }
+    if (getLE(m_data + 8, 2) != kRecordingVersion) {
+        err = "unsupported recording version in " + path;
+        close();
+        return false;
+    }
+    m_dataStart = static_cast<size_t>(getLE(m_data + 10, 2));
+    if (m_dataStart < kRecordingHeaderSize || m_dataStart > m_size) { err = "corrupt recording header"; close(); return false; }
+    if (!loadTrailer()) scan();
+    m_cursor = m_dataStart;
+    return true;
+}
+
+void RawRecordingReader::close() {
+#ifdef _WIN32
+    if (m_data) ::UnmapViewOfFile(m_data);
+    if (m_mapping) ::CloseHandle(m_mapping);
+    if (m_file) ::CloseHandle(m_file);
+    m_mapping = m_file = nullptr;
+#else
+    if (m_data) ::munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_index.clear();
+    m_messageCount = m_firstTs = m_lastTs = 0;
+    m_hasTrailer = false;
+}
+
+// Trusts the trailer only if its index chain is intact
+bool RawRecordingReader::loadTrailer() {
+    if (m_size < m_dataStart + kRecordTrailerSize) return false;
+    const uint8_t* t = m_data + m_size - kRecordTrailerSize;
+    if (t[0] != static_cast<uint8_t>(RecordType::Trailer)) return false;
+    uint32_t indexCount = static_cast<uint32_t>(getLE(t + 4, 4));
+    uint64_t offset = getLE(t + 8, 8);
+    std::vector<RecordingIndexEntry> index;
+    index.reserve(indexCount);
+    uint64_t limit = m_size - kRecordTrailerSize;
+    for (uint32_t i = 0; i < indexCount; ++i) {
+        if (offset < m_dataStart || offset + kRecordIndexSize > limit) return false;
+        const uint8_t* r = m_data + offset;
+        if (r[0] != static_cast<uint8_t>(RecordType::Index)) return false;
+        index.push_back({getLE(r + 8, 8), getLE(r + 16, 8), offset + kRecordIndexSize});
+        limit = offset;
+        offset = getLE(r + 24, 8);
+    }
+    if (indexCount && offset != 0) return false;
+    std::reverse(index.begin(), index.end());
+    m_index = std::move(index);
+    m_messageCount = getLE(t + 16, 8);
+    m_firstTs = getLE(t + 24, 8);
+    m_lastTs = getLE(t + 32, 8);
+    m_dataEnd = m_size - kRecordTrailerSize;
+    m_hasTrailer = true;
+    return true;
+}
+
+bool RawRecordingReader::scan() {
+    size_t pos = m_dataStart;
+    while (pos < m_size) {
+        const uint8_t* r = m_data + pos;
+        auto type = static_cast<RecordType>(r[0]);
+        if (type == RecordType::Message) {
+            if (m_size - pos < kRecordMessageHeaderSize) break;
+            size_t n = r[4];
+            if (n > kMax1553DataWords || m_size - pos < kRecordMessageHeaderSize + 2 * n) break;
+            uint64_t ts = getLE(r + 8, 8);
+            if (m_messageCount == 0) m_firstTs = ts;
+            m_lastTs = ts;
+            ++m_messageCount;
+            pos += kRecordMessageHeaderSize + 2 * n;
+        } else if (type == RecordType::Index) {
+            if (m_size - pos < kRecordIndexSize) break;
+            m_index.push_back({getLE(r + 8, 8), getLE(r + 16, 8), pos + kRecordIndexSize});
+            pos += kRecordIndexSize;
+        } else {
+            break; // trailer, or a torn final record
+        }
+    }
+    m_dataEnd = pos;
+    return true;
+}
+
+const uint8_t* RawRecordingReader::message() {
+    while (m_cursor < m_dataEnd) {
+        const uint8_t* r = m_data + m_cursor;
+        if (r[0] == static_cast<uint8_t>(RecordType::Index)) { m_cursor += kRecordIndexSize; continue; }
+        if (r[0] != static_cast<uint8_t>(RecordType::Message)) return nullptr;
+        size_t n = r[4];
+        if (n > kMax1553DataWords || m_dataEnd - m_cursor < kRecordMessageHeaderSize + 2 * n) return nullptr;
+        return r;
+    }
+    return nullptr;
+}
+
+bool RawRecordingReader::next(Raw1553Message& out) {
+    const uint8_t* r = message();
+    if (!r) return false;
+    size_t n = r[4];
+    out.tx = (r[1] & 0x1) != 0;
+    out.isModeCode = (r[1] & 0x2) != 0;
+    out.bus = static_cast<uint16_t>(r[1] >> 2);
+    out.rtAddress = r[2];
+    out.subAddress = r[3];
+    out.dataWordCount = static_cast<uint16_t>(n);
+    out.channel = r[5];
+    out.wordCount = static_cast<uint16_t>(getLE(r + 6, 2));
+    out.timestamp = getLE(r + 8, 8);
+    out.statusWord1 = static_cast<uint32_t>(getLE(r + 16, 4));
+    out.statusWord2 = static_cast<uint32_t>(getLE(r + 20, 4));
+    const uint8_t* w = r + kRecordMessageHeaderSize;
+    for (size_t i = 0; i < n; ++i) out.dataWords[i] = static_cast<uint16_t>(w[2 * i] | (w[2 * i + 1] << 8));
+    m_cursor += kRecordMessageHeaderSize + 2 * n;
+    return true;
+}
+
+bool RawRecordingReader::peek(Peek& out) {
+    const uint8_t* r = message();
+    if (!r) return false;
+    out.timestamp = getLE(r + 8, 8);
+    out.rt = r[2];
+    out.sa = r[3];
+    out.tx = (r[1] & 0x1) != 0;
+    return true;
+}
+
+void RawRecordingReader::skip() {
+    if (const uint8_t* r = message()) m_cursor += kRecordMessageHeaderSize + 2 * static_cast<size_t>(r[4]);
+}
+
+void RawRecordingReader::seek(uint64_t timestamp) {
+    auto it = std::upper_bound(m_index.begin(), m_index.end(), timestamp,
+                               [](uint64_t ts, const RecordingIndexEntry& e) { return ts < e.timestamp; });
+    m_cursor = (it == m_index.begin()) ? m_dataStart : static_cast<size_t>((it - 1)->offset);
+}
+
+} // namespace ddc
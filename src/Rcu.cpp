@@ -0,0 +1,29 @@
+#include "Rcu.hpp"
+#include <chrono>
+#include <thread>
+
+namespace ddc {
+
+RcuDomain::Reader* RcuDomain::addReader() {
+    std::lock_guard<std::mutex> lk(m_mtx);
+    m_readers.push_back(std::make_unique<Reader>());
+    m_readers.back()->m_domain = this;
+    return m_readers.back().get();
+}
+
+void RcuDomain::synchronize() {
+    const uint64_t target = m_epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::vector<const Reader*> readers;
+    {
+        std::lock_guard<std::mutex> lk(m_mtx);
+        for (const auto& r : m_readers) readers.push_back(r.get());
+    }
+    for (const Reader* r : readers) {
+        // Offline readers read as kOffline, which is past any target
+        while (r->m_seen.load(std::memory_order_acquire) < target)
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+} // namespace ddc
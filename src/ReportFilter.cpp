@@ -0,0 +1,55 @@
+#include "ReportFilter.hpp"
+#include "Atomics.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace ddc {
+
+ReportFilter::ReportFilter(const std::vector<FieldSpec>& fields) { update(fields); }
+
+void ReportFilter::update(const std::vector<FieldSpec>& fields) {
+    if (m_fields.size() < fields.size()) m_fields.resize(fields.size());
+    m_active = false;
+    for (size_t id = 0; id < fields.size(); ++id) {
+        const FieldReport& r = fields[id].report;
+        Field& f = m_fields[id];
+        f.enabled = r.enabled;
+        f.deadband = r.deadband;
+        f.deadbandFraction = r.deadbandPct / 100.0;
+        f.minUs = static_cast<uint64_t>(r.minIntervalMs) * 1000;
+        f.maxUs = static_cast<uint64_t>(r.maxIntervalMs) * 1000;
+        m_active = m_active || r.enabled;
+    }
+}
+
+size_t ReportFilter::apply(const FieldValue* in, size_t count, FieldValue* out) {
+    size_t n = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (due(in[i])) out[n++] = in[i];
+    }
+    singleWriterAdd(m_passed, n);
+    singleWriterAdd(m_suppressed, count - n);
+    return n;
+}
+
+bool ReportFilter::due(const FieldValue& v) {
+    if (v.fieldId >= m_fields.size()) return true;
+    Field& f = m_fields[v.fieldId];
+    if (!f.enabled) return true;
+    if (f.reported) {
+        // Out-of-order timestamps (multi-device merge) count as no time passed
+        uint64_t elapsed = v.timestamp > f.lastTs ? v.timestamp - f.lastTs : 0;
+        if (elapsed < f.minUs) return false;
+        bool heartbeat = f.maxUs && elapsed >= f.maxUs;
+        double band = std::max(f.deadband, f.deadbandFraction * std::fabs(f.last));
+        bool changed = std::isnan(v.value) != std::isnan(f.last) ||
+                       (band > 0 ? std::fabs(v.value - f.last) > band : v.value != f.last && !std::isnan(v.value));
+        if (!changed && !heartbeat) return false;
+    }
+    f.reported = true;
+    f.last = v.value;
+    f.lastTs = v.timestamp;
+    return true;
+}
+
+} // namespace ddc
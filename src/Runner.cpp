@@ -4,21 +4,41 @@
 #include <thread>
 #include <atomic>
 #include "B1553Monitor.hpp"
+#include "BusSimulator.hpp"
 #include "MessageParser.hpp"
-#include "UdpPublisher.hpp"
 #include "JsonFormatter.hpp"
 #include "Config.hpp"
 #include "ExtractionEngine.hpp"
+#include "ExtractionPool.hpp"
 #include "CsvLogger.hpp"
-#include <unordered_set>
+#include "ConfigReloader.hpp"
+#include "AcceptanceMask.hpp"
+#include "BusAnalyzer.hpp"
+#include "OutputFanout.hpp"
+#include "LatencyStats.hpp"
+#include "Metrics.hpp"
+#include "StatsReporter.hpp"
+#include "ReportFilter.hpp"
+#include "RawRecorder.hpp"
+#include "TimestampMerger.hpp"
+#include <memory>
+#include <csignal>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
 
+// SIGHUP asks the reloader to re-read the config
+static ddc::ConfigReloader* g_reloader = nullptr;
+#ifdef SIGHUP
+static void onSighup(int) { if (g_reloader) g_reloader->request(); }
+#endif
+
 int main(int argc, char* argv[]) {
     std::string configPath = "config.json"; // legacy default name if present
     bool userProvidedConfig = false;
     int overridePort = -1;
+    std::string recordPath, replayPath;
+    double replaySpeed = -1.0;
     for (int i=1;i<argc;++i) {
         std::string a = argv[i];
         if ((a == "-c" || a == "--config") && i+1 < argc) {
@@ -26,12 +46,22 @@ int main(int argc, char* argv[]) {
             userProvidedConfig = true;
         } else if ((a == "-p" || a == "--port") && i+1 < argc) {
             try { overridePort = std::stoi(argv[++i]); } catch(...) { std::cerr << "Invalid port after " << a << "\n"; return 1; }
+        } else if (a == "--record" && i+1 < argc) {
+            recordPath = argv[++i];
+        } else if (a == "--replay" && i+1 < argc) {
+            replayPath = argv[++i];
+        } else if (a == "--replay-speed" && i+1 < argc) {
+            try { replaySpeed = std::stod(argv[++i]); } catch(...) { replaySpeed = -2.0; }
+            if (replaySpeed < 0) { std::cerr << "Invalid speed after " << a << "\n"; return 1; }
         } else if (a == "--help" || a == "-h") {
-            std::cout << "Usage: DDCStreamerApp [-c config.json] [-p port]\n"
+            std::cout << "Usage: DDCStreamerApp [-c config.json] [-p port] [--record file] [--replay file [--replay-speed N]]\n"
                          "  -c, --config   Path to configuration JSON.\n"
                          "                  If omitted, first existing is chosen from:\n"
                          "                  config.nested.sample.json, config.sample.json, config.json\n"
-                         "  -p, --port     Override UDP port (ignores udp_port in config)\n";
+                         "  -p, --port     Override UDP port (ignores udp_port in config)\n"
+                         "  --record       Write raw bus traffic to a recording (overrides record_path)\n"
+                         "  --replay       Read messages from a recording instead of the device\n"
+                         "  --replay-speed 1 = real time (default), N = N times faster, 0 = as fast as possible\n";
             return 0;
         }
     }
@@ -61,10 +91,11 @@ int main(int argc, char* argv[]) {
         if (overridePort > 65535) { std::cerr << "Port out of range" << std::endl; return 1; }
         cfg.udpPort = static_cast<uint16_t>(overridePort);
     }
+    if (!recordPath.empty()) cfg.recordPath = recordPath;
+    if (!replayPath.empty()) cfg.replayPath = replayPath;
+    if (replaySpeed >= 0) cfg.replaySpeed = replaySpeed;
 
-    ddc::B1553Monitor monitor;
     ddc::MessageParser parser;
-    ddc::UdpPublisher udp;
     ddc::ExtractionEngine engine(cfg);
     ddc::CsvLogger csv;
     if(!cfg.csvPath.empty()) {
@@ -98,106 +129,318 @@ int main(int argc, char* argv[]) {
                 std::ostringstream ds; ds<<year<<mon<<day<<"_"<<hour<<min<<sec; replaceAll(cfg.csvPath, "{datetime}", ds.str());
             }
         }
-        // Collect full ordered field list for stable CSV header
+        // Collect full field list in field id order for stable CSV header
         std::vector<std::string> allFields;
-        for (auto &stream : cfg.streams) {
-            for (auto &f : stream.fields) allFields.push_back(f.name);
-        }
+        for (uint32_t id = 0; id < engine.fieldCount(); ++id) allFields.push_back(engine.fieldName(id));
     csv.setColumns(allFields);
     csv.open(cfg.csvPath);
     }
 
-    if(!monitor.open(cfg.device, cfg.channelMask)) { std::cerr << "Failed to open device" << std::endl; return 1; }
-    if (cfg.simulation) {
-        // Derive RT/SA sets from config fields
-        std::vector<uint16_t> rts, sas;
-        {
-            std::unordered_set<uint16_t> rtSet, saSet;
-            for (auto &stream : cfg.streams) {
-                for (auto &f : stream.fields) { rtSet.insert(f.rt); saSet.insert(f.subAddress); }
-            }
-            rts.assign(rtSet.begin(), rtSet.end());
-            sas.assign(saSet.begin(), saSet.end());
+    // One monitor (and acquisition thread) per device; a replay is a single source
+    const bool replay = !cfg.replayPath.empty();
+    const size_t deviceCount = replay ? 1 : cfg.devices.size();
+    std::vector<std::unique_ptr<ddc::B1553Monitor>> monitors;
+    for (size_t i = 0; i < deviceCount; ++i) {
+        const auto& dev = cfg.devices[i];
+        auto monitor = std::make_unique<ddc::B1553Monitor>();
+        if(!monitor->open(dev.name, dev.channelMask)) { std::cerr << "Failed to open device " << dev.name << std::endl; return 1; }
+        monitor->setBus(static_cast<uint16_t>(i));
+        if (replay) {
+            if (!monitor->enableReplay(cfg.replayPath, cfg.replaySpeed, err)) { std::cerr << "Replay error: " << err << std::endl; return 1; }
+        } else if (cfg.simulation) {
+            ddc::AppConfig simCfg = cfg;
+            simCfg.simSchedule = dev.simSchedule;
+            monitor->enableSimulation(simCfg);
+            auto sim = monitor->simulator();
+            std::cout << "Simulating " << dev.name << ": " << sim->entryCount() << " scheduled messages, "
+                      << sim->messagesPerSecond() << " msg/s in " << sim->minorFrameHz() << " Hz minor frames" << std::endl;
+            if (sim->scheduledLoad() >= 1.0)
+                std::cerr << "Warning: " << dev.name << " sim_schedule needs " << sim->scheduledLoad()
+                          << "x the bus time of a 1 Mbps bus; messages that do not fit are dropped" << std::endl;
         }
-    bool randomPattern = (cfg.simPattern != "increment");
-    monitor.enableSimulation(cfg.simRateHz, rts, sas, 32, randomPattern);
-        // Pattern flag (reflection not direct; add setter if needed) -> quick hack via dynamic cast not available; adjust header? For brevity not modifying further.
+        monitors.push_back(std::move(monitor));
     }
-    if(!udp.open(cfg.udpHost, cfg.udpPort)) { std::cerr << "Failed to open UDP" << std::endl; return 1; }
+    ddc::OutputFanout output(cfg, engine);
+    if(!output.open(err)) { std::cerr << "Failed to open UDP: " << err << std::endl; return 1; }
+
+    ddc::RawRecorder recorder;
+    if (!cfg.recordPath.empty() && !recorder.open(cfg.recordPath, err)) { std::cerr << "Record error: " << err << std::endl; return 1; }
 
-    std::cout << "Streaming from " << cfg.device << " to " << cfg.udpHost << ":" << cfg.udpPort
-              << " using config " << configPath;
+    std::cout << "Streaming from";
+    if (replay) std::cout << " " << cfg.replayPath;
+    else for (size_t i = 0; i < deviceCount; ++i) std::cout << (i ? ", " : " ") << cfg.devices[i].name;
+    std::cout << " to";
+    for (size_t i = 0; i < output.sinkCount(); ++i)
+        std::cout << (i ? ", " : " ") << output.sink(i).host << ":" << output.sinkPort(i);
+    std::cout << " using config " << configPath;
     if (overridePort > 0) std::cout << " (port overridden)";
     std::cout << std::endl;
+    if (const ddc::GeneratedDecoders* g = ddc::generatedDecoders()) {
+        if (engine.generated()) std::cout << "Decoders: generated from " << g->source << std::endl;
+        else std::cout << "Decoders: table (generated decoders are for " << g->source << ")" << std::endl;
+    }
+
+    // Reused for every message; sized so extract() never truncates
+    std::vector<ddc::FieldValue> extracted(engine.maxValuesPerMessage());
+
+    // Capture threads only enqueue; merging, recording, parsing, extraction and output run on
+    // the processing thread so a slow sendto or disk write cannot stall bus acquisition.
+    ddc::TimestampMerger merger(deviceCount, cfg.queueCapacity, cfg.queuePolicy, cfg.mergeWindowUs);
+    std::atomic<bool> processing{true};
+
+    // Exception reporting for immediate output (and CSV with csv_on_change). Runs on whichever
+    // thread produces the values: the processing thread, or the pool's gather thread.
+    ddc::ReportFilter filter(engine.fields());
+    const bool filterOutputs = output.hasImmediate() || (cfg.csvOnChange && !cfg.csvPath.empty());
+    bool filtering = filter.active() && filterOutputs;
+    std::vector<ddc::FieldValue> reported(engine.maxValuesPerMessage());
+    uint64_t emitGeneration = engine.generation();
+    auto emit = [&](const ddc::FieldValue* values, size_t count, uint64_t captureNs){
+        if (engine.generation() != emitGeneration) {
+            // Config reload: new report settings, last reported values kept
+            emitGeneration = engine.generation();
+            filter.update(engine.fields());
+            filtering = filter.active() && filterOutputs;
+        }
+        if (reported.size() < count) reported.resize(count);
+        size_t due = filtering ? filter.apply(values, count, reported.data()) : count;
+        const ddc::FieldValue* dueValues = filtering ? reported.data() : values;
+        if (due > 0 && output.hasImmediate()) output.publish(dueValues, due, captureNs);
+        if (cfg.csvPath.empty()) return;
+        if (cfg.csvOnChange) { if (due > 0) csv.writeValues(dueValues, due); }
+        else csv.writeValues(values, count);
+    };
+
+    // Per-stage latency: the processing thread (or each pool worker) and the output path
+    // record into their own shards; reports merge them.
+    ddc::LatencyStats latency;
+    ddc::LatencyStats::Shard* processingLatency = cfg.latencyStats ? latency.addShard("processing") : nullptr;
+    if (cfg.latencyStats) output.setLatency(latency.addShard("output"));
 
-    std::atomic<bool> running{true};
-    std::atomic<uint64_t> seq{0};
-
-    monitor.start([&](const ddc::Raw1553Message& raw){
-        auto p = parser.parse(raw);
-        if(!p) return;
-        auto extracted = engine.process(*p);
-        if (!cfg.batchMessages) {
-            for (auto& ev : extracted) {
-                nlohmann::json j;
-                // Include both microseconds and seconds
-                j["timestamp_us"] = ev.timestamp;
-                j["timestamp"] = static_cast<double>(ev.timestamp)/1e6;
-                // Add ISO8601 datetime similar to python utilities
-                try {
-                    auto now = std::chrono::system_clock::now();
-                    std::time_t t = std::chrono::system_clock::to_time_t(now);
-                    auto tm = *std::gmtime(&t);
-                    std::ostringstream oss;
-                    oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%SZ");
-                    j["datetime"] = oss.str();
-                } catch(...) {}
-                j["seq"] = seq.fetch_add(1, std::memory_order_relaxed);
-                // Nested path support
-                if (ev.name.find('.') != std::string::npos) {
-                    // reuse same helper logic (simple reimplementation)
-                    size_t start = 0; nlohmann::json* cur = &j;
-                    std::string path = ev.name;
-                    while (true) {
-                        size_t dot = path.find('.', start);
-                        std::string key = (dot == std::string::npos) ? path.substr(start) : path.substr(start, dot - start);
-                        if (dot == std::string::npos) { (*cur)[key] = ev.numericValue; break; }
-                        cur = &((*cur)[key]);
-                        start = dot + 1;
-                    }
-                } else {
-                    j[ev.name] = ev.numericValue;
-                }
-                std::string payload = j.dump();
-                udp.send(payload);
+    // Pipeline counters: one shard per capture thread, the processing thread and each worker
+    ddc::Metrics metrics;
+    std::vector<ddc::Metrics::Shard*> captureMetrics;
+    for (size_t i = 0; i < deviceCount; ++i) captureMetrics.push_back(metrics.addShard());
+    ddc::Metrics::Shard* processingMetrics = metrics.addShard();
+    // Parsed message without a pool: per-key counts, or unmatched if the key is out of range
+    auto countMessage = [&](const ddc::Raw1553Message& raw, size_t values){
+        if (!ddc::msgKeyInRange(raw.rtAddress, raw.subAddress)) { processingMetrics->add(ddc::Counter::Unmatched); return; }
+        size_t key = ddc::msgKeyIndex(raw.rtAddress, raw.subAddress, raw.tx);
+        processingMetrics->message(key, engine.plan().slot(key).count, values);
+    };
+
+    // With workers, parse + extract move to a pool sharded by message key; its gather
+    // thread then owns immediate output, CSV and the flush that is otherwise done here.
+    std::unique_ptr<ddc::ExtractionPool> pool;
+    if (cfg.workers > 0) {
+        bool forward = output.hasImmediate() || !cfg.csvPath.empty();
+        pool = std::make_unique<ddc::ExtractionPool>(engine, cfg.workers, cfg.queueCapacity, forward);
+        if (cfg.latencyStats) pool->setLatency(&latency);
+        pool->setMetrics(&metrics);
+        pool->start(emit, [&]{ output.flush(); });
+    }
+
+    // Bus schedule check on every merged message, in bus-time order
+    std::unique_ptr<ddc::BusAnalyzer> busAnalyzer;
+    if (cfg.busAnalyzer) busAnalyzer = std::make_unique<ddc::BusAnalyzer>(cfg.expectedRates);
+
+    auto processMessage = [&](const ddc::Raw1553Message& raw){
+        if (!cfg.recordPath.empty()) recorder.record(raw);
+        if (busAnalyzer && ddc::msgKeyInRange(raw.rtAddress, raw.subAddress))
+            busAnalyzer->observe(ddc::msgKeyIndex(raw.rtAddress, raw.subAddress, raw.tx), raw.timestamp);
+        processingMetrics->add(ddc::Counter::Processed);
+        if (pool) { if (!pool->dispatch(raw)) countMessage(raw, 0); return; }
+        ddc::ParsedMessage p;
+        uint64_t t = processingLatency ? processingLatency->since(ddc::LatencyStage::Queue, raw.hostTimeNs) : 0;
+        const bool timed = processingLatency && processingLatency->sample();
+        if(!parser.parse(raw, p)) { processingMetrics->add(ddc::Counter::ParseErrors); return; }
+        if (timed) t = processingLatency->since(ddc::LatencyStage::Parse, t);
+        size_t count = engine.extract(p, extracted);
+        if (timed) processingLatency->since(ddc::LatencyStage::Extract, t);
+        countMessage(raw, count);
+        if (count > 0) emit(extracted.data(), count, raw.hostTimeNs);
+    };
+
+    // Reader of the engine's tables (and, through emit, the output's), for config reloads
+    ddc::RcuDomain::Reader* processingReader = engine.rcu().addReader();
+    std::thread processingThread([&]{
+        ddc::Raw1553Message raw;
+        int idleSpins = 0;
+        processingReader->online();
+        for (;; processingReader->quiescent()) {
+            if (merger.pop(raw)) { idleSpins = 0; processMessage(raw); continue; }
+            if (idleSpins == 0 && !pool) output.flush(); // rings drained: hand queued datagrams to the kernel
+            if (!processing.load()) {
+                // Producers stopped: release whatever the reorder window still holds
+                if (merger.drain(raw)) { processMessage(raw); continue; }
+                break;
             }
+            if (++idleSpins < 64) std::this_thread::yield();
+            else std::this_thread::sleep_for(std::chrono::microseconds(100));
         }
-        if (!extracted.empty() && !cfg.csvPath.empty()) csv.writeValues(extracted);
+        processingReader->offline();
     });
 
-    // If batch mode, run a rate-controlled loop
-    std::thread batchThread;
-    if (cfg.batchMessages) {
-        batchThread = std::thread([&]{
-            using namespace std::chrono;
-            auto interval = duration<double>(1.0 / (cfg.outputRateHz > 0 ? cfg.outputRateHz : 50.0));
-            while (running.load()) {
-                auto snap = engine.buildJsonSnapshot();
-                if (!snap.empty()) {
-                    snap["seq"] = seq.fetch_add(1, std::memory_order_relaxed);
-                    std::string payload = snap.dump();
-                    udp.send(payload);
-                }
-                std::this_thread::sleep_for(interval);
+    // Pre-parse filter: only keys with fields reach the capture queues. A recording keeps
+    // all traffic, so it can be replayed with another config, and the bus analyzer has to see
+    // every key to report unexpected traffic.
+    const bool acceptanceFilter = cfg.acceptanceFilter && cfg.recordPath.empty() && !cfg.busAnalyzer;
+    if (acceptanceFilter) {
+        ddc::AcceptanceMask mask = ddc::AcceptanceMask::fromPlan(engine.plan());
+        for (auto& monitor : monitors) monitor->setAcceptance(mask);
+        std::cout << "Acceptance filter: " << mask.keyCount() << " of " << ddc::kMsgKeySpace << " keys" << std::endl;
+    } else if (cfg.acceptanceFilter && cfg.busAnalyzer) {
+        std::cerr << "Warning: acceptance_filter is off while bus_analyzer is on (the analyzer sees all traffic)" << std::endl;
+    }
+
+    const auto timeBase = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < deviceCount; ++i) {
+        monitors[i]->setTimeBase(timeBase);
+        ddc::Metrics::Shard* counts = captureMetrics[i];
+        monitors[i]->start([&merger, i, counts](const ddc::Raw1553Message& raw){
+            counts->add(ddc::Counter::Captured);
+            if (!merger.push(i, raw)) counts->add(ddc::Counter::CaptureDropped);
+        });
+    }
+
+    // Batch sinks run their own rate-controlled loops
+    output.start();
+
+    // Hot reload of field definitions: file polling and / or SIGHUP
+    ddc::ConfigReloader reloader(cfg, engine, output);
+    reloader.start(configPath, cfg.configPollMs, [&](bool ok, const std::string& message){
+        if (ok && acceptanceFilter) {
+            // Runs after the swap: messages of new keys pass from here on
+            ddc::AcceptanceMask mask = ddc::AcceptanceMask::fromPlan(engine.plan());
+            for (auto& monitor : monitors) monitor->setAcceptance(mask);
+        }
+        if (ok) std::cout << "Config reloaded: " << message << std::endl;
+        else std::cerr << "Config reload failed: " << message << std::endl;
+    });
+    g_reloader = &reloader;
+#ifdef SIGHUP
+    std::signal(SIGHUP, onSighup);
+#endif
+
+    // Periodic report; the histograms are cumulative since start
+    std::atomic<bool> reporting{cfg.latencyStats && cfg.statsIntervalMs > 0};
+    std::thread statsThread([&]{
+        auto next = std::chrono::steady_clock::now();
+        while (reporting.load()) {
+            next += std::chrono::milliseconds(cfg.statsIntervalMs);
+            while (reporting.load() && std::chrono::steady_clock::now() < next)
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            if (reporting.load()) std::cout << "Latency:\n" << latency.report() << std::flush;
+        }
+    });
+
+    // Stats datagrams: counters, latency, queues and sinks, plus per-key counts
+    ddc::StatsReporter statsReporter(metrics, cfg.latencyStats ? &latency : nullptr);
+    statsReporter.setBusAnalyzer(busAnalyzer.get());
+    if (cfg.statsPort != 0) {
+        if (!statsReporter.open(cfg.statsHost, cfg.statsPort, err)) { std::cerr << "Stats error: " << err << std::endl; return 1; }
+        statsReporter.start(cfg.statsIntervalMs > 0 ? cfg.statsIntervalMs : 1000, [&](nlohmann::json& j){
+            auto& devices = j["devices"] = nlohmann::json::array();
+            for (size_t i = 0; i < deviceCount; ++i) {
+                const auto& ring = merger.input(i);
+                devices.push_back({{"name", cfg.devices[i].name}, {"accepted", monitors[i]->accepted()},
+                                   {"filtered", monitors[i]->filtered()}, {"queue_depth", ring.size()},
+                                   {"queue_high_water", ring.highWaterMark()}, {"overruns", ring.overruns()},
+                                   {"producer_stalls", ring.stalls()}});
+            }
+            if (pool) {
+                auto& workers = j["workers"] = nlohmann::json::array();
+                for (size_t i = 0; i < pool->workerCount(); ++i)
+                    workers.push_back({{"messages", pool->processed(i)}, {"queue_depth", pool->input(i).size()},
+                                       {"queue_high_water", pool->input(i).highWaterMark()}});
+            }
+            auto& sinks = j["sinks"] = nlohmann::json::array();
+            for (size_t i = 0; i < output.sinkCount(); ++i) {
+                auto us = output.sinkStats(i);
+                sinks.push_back({{"host", output.sink(i).host}, {"port", output.sinkPort(i)},
+                                 {"datagrams", us.datagrams}, {"bytes", us.bytes}, {"send_errors", us.sendErrors},
+                                 {"would_block", us.wouldBlock}, {"dropped", us.dropped}});
             }
+            if (!cfg.csvPath.empty())
+                j["csv"] = {{"rows", csv.rows()}, {"queue_depth", csv.queueDepth()},
+                            {"queue_high_water", csv.queueHighWater()}, {"producer_stalls", csv.producerStalls()}};
+            if (filtering) j["report_filter"] = {{"passed", filter.passed()}, {"suppressed", filter.suppressed()}};
         });
     }
 
-    std::cout << "Press Enter to stop..." << std::endl; std::string line; std::getline(std::cin, line);
-    running = false;
-    monitor.stop();
-    if (batchThread.joinable()) batchThread.join();
-    udp.close();
-    csv.flush();
+    if (cfg.replayPath.empty()) {
+        std::cout << "Press Enter to stop..." << std::endl; std::string line; std::getline(std::cin, line);
+    } else {
+        while (!monitors[0]->finished()) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+#ifdef SIGHUP
+    std::signal(SIGHUP, SIG_DFL);
+#endif
+    g_reloader = nullptr;
+    reloader.stop();
+    for (auto& monitor : monitors) monitor->stop();
+    processing = false;
+    processingThread.join();
+    if (pool) pool->stop();
+    output.stop();
+    statsReporter.stop();
+    reporting = false;
+    statsThread.join();
+    for (size_t i = 0; i < deviceCount; ++i) {
+        const auto& ring = merger.input(i);
+        std::string name = deviceCount > 1 ? " " + cfg.devices[i].name : std::string();
+        if (auto sim = monitors[i]->simulator()) {
+            std::cout << "Simulation" << name << ": frames " << sim->frames() << ", messages " << sim->messages()
+                      << ", dropped (bus full) " << sim->overflowed() << ", late frames " << monitors[i]->simLateFrames()
+                      << ", bus load " << sim->busLoad() << std::endl;
+        }
+        if (acceptanceFilter)
+            std::cout << "Acceptance filter" << name << ": accepted " << monitors[i]->accepted()
+                      << ", filtered " << monitors[i]->filtered() << std::endl;
+        std::cout << "Capture queue" << name << ": capacity " << ring.capacity()
+                  << ", high-water " << ring.highWaterMark()
+                  << ", overruns " << ring.overruns()
+                  << ", producer stalls " << ring.stalls() << std::endl;
+    }
+    if (deviceCount > 1) std::cout << "Merge: out of order " << merger.outOfOrder() << std::endl;
+    for (size_t i = 0; pool && i < pool->workerCount(); ++i) {
+        std::cout << "Worker " << i << ": messages " << pool->processed(i)
+                  << ", queue high-water " << pool->input(i).highWaterMark() << std::endl;
+    }
+    for (size_t i = 0; i < output.batchTickCount(); ++i) {
+        auto bs = output.batchTickStats(i);
+        std::cout << "Batch " << output.batchTickName(i) << " @ " << output.batchTickRate(i) << " Hz: ticks " << bs.ticks
+                  << ", missed " << bs.missed << ", lateness mean " << bs.meanLatenessUs << " us, max "
+                  << bs.maxLatenessUs << " us" << std::endl;
+    }
+    std::cout << "Counters:";
+    for (size_t i = 0; i < ddc::kCounterCount; ++i)
+        std::cout << (i ? ", " : " ") << ddc::counterName(static_cast<ddc::Counter>(i)) << " "
+                  << metrics.total(static_cast<ddc::Counter>(i));
+    std::cout << std::endl;
+    if (cfg.statsPort != 0) std::cout << "Stats reports: " << statsReporter.reports() << std::endl;
+    if (reloader.reloads() || reloader.failures())
+        std::cout << "Config reloads: " << reloader.reloads() << ", failed " << reloader.failures() << std::endl;
+    if (cfg.latencyStats) std::cout << "Latency:\n" << latency.report();
+    if (busAnalyzer) std::cout << "Bus schedule:\n" << busAnalyzer->report();
+    if (filtering) std::cout << "Report filter: passed " << filter.passed() << ", suppressed " << filter.suppressed() << std::endl;
+    for (size_t i = 0; i < output.sinkCount(); ++i) {
+        auto us = output.sinkStats(i);
+        std::cout << "UDP " << output.sink(i).host << ":" << output.sinkPort(i)
+                  << ": datagrams " << us.datagrams << ", bytes " << us.bytes
+                  << ", syscalls " << us.syscalls << ", send errors " << us.sendErrors
+                  << ", would-block " << us.wouldBlock << ", dropped " << us.dropped << std::endl;
+    }
+    if (!cfg.recordPath.empty()) {
+        recorder.close();
+        std::cout << "Recording " << cfg.recordPath << ": messages " << recorder.messages()
+                  << ", bytes " << recorder.bytes() << ", queue high-water " << recorder.queueHighWater()
+                  << ", producer stalls " << recorder.producerStalls() << std::endl;
+    }
+    if (!cfg.csvPath.empty()) {
+        csv.close();
+        std::cout << "CSV: rows " << csv.rows() << ", queue high-water " << csv.queueHighWater()
+                  << ", producer stalls " << csv.producerStalls() << std::endl;
+    }
     return 0;
 }
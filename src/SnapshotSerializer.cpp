@@ -0,0 +1,153 @@
+#include "SnapshotSerializer.hpp"
+#include <algorithm>
+#include <map>
+#include <nlohmann/json.hpp>
+
+namespace ddc {
+
+namespace {
+
+// Build-time key tree; std::map gives the same key order as nlohmann::json objects.
+struct KeyTree {
+    bool leaf{false};
+    int meta{-1};                  // index into kMetaKeys for metadata leaves
+    std::vector<uint32_t> ids;     // field ids (leaf)
+    std::map<std::string, KeyTree> children;
+};
+
+const char* const kMetaKeys[] = {"timestamp_us", "timestamp", "datetime", "seq"};
+
+// Mirrors setNestedValue(): a.b.c -> {"a":{"b":{"c":v}}}. Names whose path collides
+// with another field's leaf/object are skipped; the DOM path cannot represent them either.
+void insertField(KeyTree& root, const std::string& name, uint32_t id) {
+    KeyTree* cur = &root;
+    size_t start = 0;
+    while (true) {
+        size_t dot = name.find('.', start);
+        std::string key = (dot == std::string::npos) ? name.substr(start) : name.substr(start, dot - start);
+        auto it = cur->children.find(key);
+        if (dot == std::string::npos) {
+            if (it != cur->children.end() && !it->second.leaf) return;
+            KeyTree& leaf = cur->children[key];
+            leaf.leaf = true;
+            leaf.ids.push_back(id);
+            return;
+        }
+        if (it != cur->children.end() && it->second.leaf) return;
+        cur = &cur->children[key];
+        start = dot + 1;
+    }
+}
+
+} // namespace
+
+SnapshotSerializer::SnapshotSerializer(const std::vector<std::string>& fieldNames,
+                                       const std::vector<uint32_t>& fieldIds) {
+    KeyTree root;
+    if (fieldIds.empty()) {
+        for (uint32_t id = 0; id < fieldNames.size(); ++id) insertField(root, fieldNames[id], id);
+    } else {
+        std::vector<uint32_t> ids(fieldIds);
+        std::sort(ids.begin(), ids.end());
+        for (uint32_t id : ids) if (id < fieldNames.size()) insertField(root, fieldNames[id], id);
+    }
+    // Metadata is assigned after the fields, so it replaces any field with the same key
+    for (int m = 0; m < 4; ++m) {
+        KeyTree meta;
+        meta.leaf = true;
+        meta.meta = m;
+        root.children[kMetaKeys[m]] = std::move(meta);
+    }
+
+    // Flatten in preorder
+    struct Flattener {
+        SnapshotSerializer& self;
+        void run(const KeyTree& t, uint32_t parent) {
+            for (const auto& kv : t.children) {
+                uint32_t index = static_cast<uint32_t>(self.m_nodes.size());
+                Node n;
+                n.key = nlohmann::json(kv.first).dump() + ":";
+                n.parent = parent;
+                const KeyTree& c = kv.second;
+                if (c.meta >= 0) {
+                    n.kind = static_cast<Kind>(static_cast<int>(Kind::TimestampUs) + c.meta);
+                } else if (c.leaf) {
+                    n.kind = Kind::Field;
+                    n.firstId = static_cast<uint32_t>(self.m_leafIds.size());
+                    n.idCount = static_cast<uint32_t>(c.ids.size());
+                    self.m_leafIds.insert(self.m_leafIds.end(), c.ids.begin(), c.ids.end());
+                }
+                self.m_nodes.push_back(std::move(n));
+                if (!c.leaf) run(c, index);
+                self.m_nodes[index].end = static_cast<uint32_t>(self.m_nodes.size());
+            }
+        }
+    };
+    Flattener{*this}.run(root, kNoParent);
+    m_present.resize(m_nodes.size());
+}
+
+void SnapshotSerializer::serialize(const ValueSnapshot& snap, uint64_t seq, std::string& out) {
+    // Children follow their parent in preorder, so a reverse pass settles every
+    // object's presence before the object itself is visited.
+    uint64_t latestTs = 0;
+    std::fill(m_present.begin(), m_present.end(), 0);
+    for (size_t i = m_nodes.size(); i-- > 0;) {
+        const Node& n = m_nodes[i];
+        if (n.kind == Kind::Field) {
+            for (uint32_t k = 0; k < n.idCount; ++k) {
+                uint32_t id = m_leafIds[n.firstId + k];
+                if (id < snap.valid.size() && snap.valid[id]) {
+                    m_present[i] = 1;
+                    if (snap.timestamps[id] > latestTs) latestTs = snap.timestamps[id];
+                }
+            }
+        } else if (n.kind != Kind::Object) {
+            m_present[i] = 1;
+        }
+        if (m_present[i] && n.parent != kNoParent) m_present[n.parent] = 1;
+    }
+    out.clear();
+    out.push_back('{');
+    emit(0, static_cast<uint32_t>(m_nodes.size()), snap, seq, latestTs, out);
+    out.push_back('}');
+}
+
+void SnapshotSerializer::emit(uint32_t first, uint32_t end, const ValueSnapshot& snap, uint64_t seq,
+                              uint64_t latestTs, std::string& out) {
+    bool firstItem = true;
+    for (uint32_t i = first; i < end; i = m_nodes[i].end) {
+        if (!m_present[i]) continue;
+        const Node& n = m_nodes[i];
+        if (!firstItem) out.push_back(',');
+        firstItem = false;
+        out.append(n.key);
+        switch (n.kind) {
+        case Kind::Object:
+            out.push_back('{');
+            emit(i + 1, n.end, snap, seq, latestTs, out);
+            out.push_back('}');
+            break;
+        case Kind::Field: {
+            // Duplicate names: the highest valid id wins, as in the DOM path
+            uint32_t id = 0;
+            for (uint32_t k = 0; k < n.idCount; ++k) {
+                uint32_t candidate = m_leafIds[n.firstId + k];
+                if (candidate < snap.valid.size() && snap.valid[candidate]) id = candidate;
+            }
+            JsonFormatter::appendDouble(out, snap.values[id]);
+            break;
+        }
+        case Kind::TimestampUs: JsonFormatter::appendUnsigned(out, latestTs); break;
+        case Kind::Timestamp: JsonFormatter::appendDouble(out, static_cast<double>(latestTs) / 1e6); break;
+        case Kind::Datetime:
+            out.push_back('"');
+            out.append(m_clock.now(), IsoSecondClock::kLength);
+            out.push_back('"');
+            break;
+        case Kind::Seq: JsonFormatter::appendUnsigned(out, seq); break;
+        }
+    }
+}
+
+} // namespace ddc
@@ -0,0 +1,132 @@
+#include "StatsReporter.hpp"
+#include <nlohmann/json.hpp>
+
+namespace ddc {
+
+StatsReporter::StatsReporter(const Metrics& metrics, const LatencyStats* latency)
+    : m_metrics(metrics), m_latency(latency), m_start(std::chrono::steady_clock::now()), m_lastReport(m_start) {}
+
+StatsReporter::~StatsReporter() { stop(); }
+
+bool StatsReporter::open(const std::string& host, uint16_t port, std::string& err) {
+    if (m_udp.open(host, port)) return true;
+    err = "cannot open stats port " + host + ":" + std::to_string(port);
+    return false;
+}
+
+void StatsReporter::start(int intervalMs, Extra extra) {
+    if (m_running.exchange(true)) return;
+    m_thread = std::thread([this, intervalMs, extra = std::move(extra)] { run(intervalMs, extra); });
+}
+
+void StatsReporter::stop() {
+    m_running = false;
+    if (m_thread.joinable()) m_thread.join();
+    m_udp.close();
+}
+
+void StatsReporter::run(int intervalMs, Extra extra) {
+    std::vector<std::string> datagrams;
+    auto next = std::chrono::steady_clock::now();
+    while (m_running.load()) {
+        next += std::chrono::milliseconds(intervalMs);
+        while (m_running.load() && std::chrono::steady_clock::now() < next)
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        // A final report on stop, so the last interval is not lost
+        build(datagrams, extra);
+        for (const auto& d : datagrams) m_udp.send(d);
+    }
+}
+
+void StatsReporter::build(std::vector<std::string>& datagrams, const Extra& extra) {
+    const auto now = std::chrono::steady_clock::now();
+    const double elapsed = std::chrono::duration<double>(now - m_lastReport).count();
+    const uint64_t seq = m_reports.load(std::memory_order_relaxed);
+    nlohmann::json j;
+    j["type"] = "stats";
+    j["seq"] = seq;
+    j["uptime_s"] = std::chrono::duration<double>(now - m_start).count();
+    nlohmann::json counters, rates;
+    for (size_t i = 0; i < kCounterCount; ++i) {
+        const char* name = counterName(static_cast<Counter>(i));
+        uint64_t total = m_metrics.total(static_cast<Counter>(i));
+        counters[name] = total;
+        rates[name] = elapsed > 0 ? static_cast<double>(total - m_lastTotals[i]) / elapsed : 0.0;
+        m_lastTotals[i] = total;
+    }
+    j["counters"] = std::move(counters);
+    j["rates_per_s"] = std::move(rates);
+    if (m_latency) {
+        nlohmann::json latency = nlohmann::json::object();
+        for (size_t i = 0; i < kLatencyStageCount; ++i) {
+            LatencySummary s = m_latency->summary(static_cast<LatencyStage>(i));
+            if (!s.count) continue;
+            latency[latencyStageName(static_cast<LatencyStage>(i))] = {
+                {"count", s.count}, {"mean_us", s.meanUs}, {"p50_us", s.p50Us},
+                {"p99_us", s.p99Us}, {"p999_us", s.p999Us}, {"max_us", s.maxUs}};
+        }
+        j["latency"] = std::move(latency);
+    }
+    if (extra) extra(j);
+    m_lastReport = now;
+
+    datagrams.clear();
+    datagrams.push_back(j.dump());
+    m_metrics.keyTotals(m_keys);
+    nlohmann::json keys = nlohmann::json::array();
+    auto flushKeys = [&] {
+        nlohmann::json k;
+        k["type"] = "key_stats";
+        k["seq"] = seq;
+        k["keys"] = std::move(keys);
+        datagrams.push_back(k.dump());
+        keys = nlohmann::json::array();
+    };
+    for (size_t key = 0; key < m_keys.size(); ++key) {
+        const auto& t = m_keys[key];
+        if (!t.messages) continue;
+        keys.push_back({{"rt", key >> 6}, {"sa", (key >> 1) & 31}, {"tr", (key & 1) ? "T" : "R"},
+                        {"messages", t.messages}, {"bounds_misses", t.boundsMisses}});
+        if (keys.size() == kKeysPerDatagram) flushKeys();
+    }
+    if (!keys.empty()) flushKeys();
+    if (m_bus) buildBusStats(seq, datagrams);
+    m_reports.store(seq + 1, std::memory_order_relaxed);
+}
+
+// Since start, plus the rate over gaps sampled since the previous report (bus time)
+void StatsReporter::buildBusStats(uint64_t seq, std::vector<std::string>& datagrams) {
+    m_bus->snapshot(m_busKeys);
+    m_lastBusKeys.resize(m_busKeys.size());
+    nlohmann::json keys = nlohmann::json::array();
+    auto flushKeys = [&] {
+        nlohmann::json k;
+        k["type"] = "bus_stats";
+        k["seq"] = seq;
+        k["keys"] = std::move(keys);
+        datagrams.push_back(k.dump());
+        keys = nlohmann::json::array();
+    };
+    for (size_t key = 0; key < m_busKeys.size(); ++key) {
+        const auto& s = m_busKeys[key];
+        const auto& last = m_lastBusKeys[key];
+        if (!s.messages && s.expectedHz <= 0) continue;
+        const uint64_t gaps = s.gaps - last.gaps, gapSum = s.gapSumUs - last.gapSumUs;
+        nlohmann::json k = {{"rt", key >> 6}, {"sa", (key >> 1) & 31}, {"tr", (key & 1) ? "T" : "R"},
+                            {"messages", s.messages}, {"rate_hz", s.rateHz()},
+                            {"recent_rate_hz", gapSum ? 1e6 * static_cast<double>(gaps) / static_cast<double>(gapSum) : 0.0},
+                            {"gap_min_us", s.minGapUs}, {"gap_mean_us", s.meanGapUs()}, {"gap_max_us", s.maxGapUs},
+                            {"jitter_rms_us", s.jitterRmsUs}, {"jitter_hist", s.jitter}, {"out_of_order", s.outOfOrder}};
+        if (s.expectedHz > 0) {
+            k["expected_hz"] = s.expectedHz;
+            k["missed"] = s.missed;
+            k["recent_missed"] = s.missed - last.missed;
+        }
+        keys.push_back(std::move(k));
+        if (keys.size() == kBusKeysPerDatagram) flushKeys();
+    }
+    if (!keys.empty()) flushKeys();
+    m_lastBusKeys.swap(m_busKeys);
+}
+
+} // namespace ddc
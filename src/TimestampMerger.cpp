@@ -0,0 +1,46 @@
+#include "TimestampMerger.hpp"
+#include <algorithm>
+
+namespace ddc {
+
+TimestampMerger::TimestampMerger(size_t sources, size_t capacity, OverflowPolicy policy, uint64_t windowUs)
+    : m_sources(std::max<size_t>(sources, 1)), m_windowUs(windowUs) {
+    for (auto& s : m_sources) s.ring = std::make_unique<SpscRing<Raw1553Message>>(capacity, policy);
+}
+
+bool TimestampMerger::next(Raw1553Message& out, bool force) {
+    if (m_sources.size() == 1) return m_sources[0].ring->pop(out); // nothing to merge
+
+    // Linear scan: a handful of devices, cheaper than maintaining a heap. `latest` is read
+    // before the pop: every push up to that timestamp is then visible, so an empty ring means
+    // nothing at or before it is pending (read after, it may cover pushes the pop missed).
+    Source* oldest = nullptr;
+    for (auto& s : m_sources) {
+        s.seen = s.latest.load(std::memory_order_acquire);
+        if (!s.hasHead) s.hasHead = s.ring->pop(s.head);
+        if (s.hasHead && (!oldest || s.head.timestamp < oldest->head.timestamp)) oldest = &s;
+    }
+    if (!oldest) return false;
+    if (!force) {
+        const uint64_t ts = oldest->head.timestamp;
+        bool safe = true;
+        uint64_t newest = 0;
+        for (auto& s : m_sources) {
+            newest = std::max(newest, s.seen);
+            if (!s.hasHead && s.seen < ts) safe = false; // may still push something older
+        }
+        if (!safe && ts + m_windowUs > newest) {
+            // Nothing new for a whole window of wall time: the quiet sources have nothing older
+            auto now = std::chrono::steady_clock::now();
+            if (newest != m_blockedNewest) { m_blockedNewest = newest; m_blockedSince = now; return false; }
+            if (now - m_blockedSince < std::chrono::microseconds(m_windowUs)) return false;
+        }
+    }
+    out = oldest->head;
+    oldest->hasHead = false;
+    if (out.timestamp < m_lastOutTs) ++m_outOfOrder;
+    else m_lastOutTs = out.timestamp;
+    return true;
+}
+
+} // namespace ddc
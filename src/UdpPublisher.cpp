@@ -1,8 +1,32 @@
 #include "UdpPublisher.hpp"
 #include <cstring>
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/udp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#endif
 
 namespace ddc {
 
+namespace {
+#ifndef _WIN32
+constexpr size_t kGsoMaxSegment = 1472;   // one segment must fit an Ethernet MTU
+constexpr size_t kGsoMaxSegments = 64;
+constexpr size_t kGsoMaxBytes = 65000;    // whole super-datagram must fit one IP packet
+constexpr int kWritableWaitMs = 1;
+#endif
+} // namespace
+
+#ifdef _WIN32
+
 UdpPublisher::UdpPublisher() {
     WSADATA wsaData{};
     if (WSAStartup(MAKEWORD(2,2), &wsaData) == 0) {
@@ -12,7 +36,7 @@ UdpPublisher::UdpPublisher() {
 
 UdpPublisher::~UdpPublisher() { close(); if (m_initialized) WSACleanup(); }
 
-bool UdpPublisher::open(const std::string& host, uint16_t port) {
+bool UdpPublisher::open(const std::string& host, uint16_t port, const UdpOptions& options) {
     std::lock_guard<std::mutex> lk(m_mtx);
     if (!m_initialized) return false;
     if (m_sock != INVALID_SOCKET) return true;
@@ -41,23 +65,254 @@ bool UdpPublisher::open(const std::string& host, uint16_t port) {
     if (ptonResult != 1) {
         return false; // No DNS resolve fallback in minimal MinGW build
     }
+    if (!applyOptions(options)) { closesocket(m_sock); m_sock = INVALID_SOCKET; return false; }
     return true;
 }
 
-bool UdpPublisher::send(const std::string& payload) {
-    std::lock_guard<std::mutex> lk(m_mtx);
+bool UdpPublisher::sendOne(const char* data, size_t size) {
     if (m_sock == INVALID_SOCKET) return false;
-    int sent = ::sendto(m_sock, payload.c_str(), static_cast<int>(payload.size()), 0,
+    int sent = ::sendto(m_sock, data, static_cast<int>(size), 0,
                         reinterpret_cast<sockaddr*>(&m_addr), sizeof(m_addr));
-    return sent == static_cast<int>(payload.size());
+    if (sent == static_cast<int>(size)) {
+        ++m_stats.datagrams; m_stats.bytes += size; ++m_stats.syscalls;
+        return true;
+    }
+    if (WSAGetLastError() == WSAEWOULDBLOCK) ++m_stats.wouldBlock; else ++m_stats.sendErrors;
+    ++m_stats.dropped;
+    return false;
+}
+
+void UdpPublisher::flushLocked() {
+    uint32_t begin = 0;
+    for (uint32_t end : m_queueEnd) {
+        sendOne(m_queue.data() + begin, end - begin);
+        begin = end;
+    }
+    m_queue.clear();
+    m_queueEnd.clear();
 }
 
 void UdpPublisher::close() {
     std::lock_guard<std::mutex> lk(m_mtx);
     if (m_sock != INVALID_SOCKET) {
+        flushLocked();
         closesocket(m_sock);
         m_sock = INVALID_SOCKET;
     }
 }
 
+#else // POSIX
+
+UdpPublisher::UdpPublisher() = default;
+
+UdpPublisher::~UdpPublisher() { close(); }
+
+bool UdpPublisher::open(const std::string& host, uint16_t port, const UdpOptions& options) {
+    std::lock_guard<std::mutex> lk(m_mtx);
+    if (m_sock >= 0) return true;
+
+    std::memset(&m_addr, 0, sizeof(m_addr));
+    m_addr.sin_family = AF_INET;
+    m_addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, host.c_str(), &m_addr.sin_addr) != 1) {
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        addrinfo* res = nullptr;
+        if (::getaddrinfo(host.c_str(), nullptr, &hints, &res) != 0 || !res) return false;
+        m_addr.sin_addr = reinterpret_cast<sockaddr_in*>(res->ai_addr)->sin_addr;
+        ::freeaddrinfo(res);
+    }
+
+    m_sock = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (m_sock < 0) return false;
+    if (!applyOptions(options)) { ::close(m_sock); m_sock = -1; return false; }
+    // Non-blocking so a full send buffer shows up as EAGAIN instead of stalling the caller
+    int flags = ::fcntl(m_sock, F_GETFL, 0);
+    if (flags >= 0) ::fcntl(m_sock, F_SETFL, flags | O_NONBLOCK);
+#if defined(__linux__)
+    int gso = 0;
+    socklen_t len = sizeof(gso);
+    m_gso = ::getsockopt(m_sock, IPPROTO_UDP, UDP_SEGMENT, &gso, &len) == 0;
+#endif
+    m_queue.reserve(64 * 1024);
+    m_queueEnd.reserve(kMaxBatch);
+    return true;
+}
+
+bool UdpPublisher::sendOne(const char* data, size_t size) {
+    if (m_sock < 0) return false;
+    bool waited = false;
+    for (;;) {
+        ssize_t sent = ::sendto(m_sock, data, size, 0, reinterpret_cast<sockaddr*>(&m_addr), sizeof(m_addr));
+        if (sent == static_cast<ssize_t>(size)) {
+            ++m_stats.datagrams; m_stats.bytes += size; ++m_stats.syscalls;
+            return true;
+        }
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            ++m_stats.wouldBlock;
+            pollfd pfd{m_sock, POLLOUT, 0};
+            if (!waited && ::poll(&pfd, 1, kWritableWaitMs) > 0) { waited = true; continue; }
+        } else {
+            ++m_stats.sendErrors;
+        }
+        ++m_stats.dropped;
+        return false;
+    }
+}
+
+void UdpPublisher::flushLocked() {
+    const size_t count = m_queueEnd.size();
+    if (count == 0) return;
+    if (m_sock < 0) {
+        m_stats.dropped += count;
+        m_queue.clear();
+        m_queueEnd.clear();
+        return;
+    }
+#if defined(__linux__)
+    mmsghdr msgs[kMaxBatch];
+    iovec iov[kMaxBatch];
+    uint32_t msgDatagrams[kMaxBatch];
+    alignas(cmsghdr) char control[kMaxBatch][CMSG_SPACE(sizeof(uint16_t))];
+    auto begin = [this](size_t i) -> uint32_t { return i == 0 ? 0 : m_queueEnd[i - 1]; };
+
+    size_t next = 0;      // first datagram not yet sent
+    bool waited = false;
+    while (next < count) {
+        // One message per datagram, or per run of equal-size datagrams when GSO is available
+        size_t msgCount = 0;
+        for (size_t d = next; d < count; ++msgCount) {
+            uint32_t first = begin(d);
+            uint32_t segment = m_queueEnd[d] - first;
+            size_t n = 1;
+            uint32_t bytes = segment;
+            if (m_gso && segment > 0 && segment <= kGsoMaxSegment) {
+                while (d + n < count && n < kGsoMaxSegments) {
+                    uint32_t len = m_queueEnd[d + n] - begin(d + n);
+                    if (len == 0 || len > segment || bytes + len > kGsoMaxBytes) break;
+                    bytes += len;
+                    ++n;
+                    if (len < segment) break; // a shorter segment may only come last
+                }
+            }
+            mmsghdr& m = msgs[msgCount];
+            std::memset(&m, 0, sizeof(m));
+            iov[msgCount].iov_base = m_queue.data() + first;
+            iov[msgCount].iov_len = bytes;
+            m.msg_hdr.msg_name = &m_addr;
+            m.msg_hdr.msg_namelen = sizeof(m_addr);
+            m.msg_hdr.msg_iov = &iov[msgCount];
+            m.msg_hdr.msg_iovlen = 1;
+            if (n > 1) {
+                m.msg_hdr.msg_control = control[msgCount];
+                m.msg_hdr.msg_controllen = sizeof(control[msgCount]);
+                cmsghdr* c = CMSG_FIRSTHDR(&m.msg_hdr);
+                c->cmsg_level = IPPROTO_UDP;
+                c->cmsg_type = UDP_SEGMENT;
+                c->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                uint16_t gsoSize = static_cast<uint16_t>(segment);
+                std::memcpy(CMSG_DATA(c), &gsoSize, sizeof(gsoSize));
+            }
+            msgDatagrams[msgCount] = static_cast<uint32_t>(n);
+            d += n;
+        }
+
+        int sent = ::sendmmsg(m_sock, msgs, static_cast<unsigned>(msgCount), 0);
+        if (sent > 0) {
+            ++m_stats.syscalls;
+            for (int k = 0; k < sent; ++k) {
+                m_stats.datagrams += msgDatagrams[k];
+                m_stats.bytes += iov[k].iov_len;
+                next += msgDatagrams[k];
+            }
+            continue;
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            ++m_stats.wouldBlock;
+            pollfd pfd{m_sock, POLLOUT, 0};
+            if (!waited && ::poll(&pfd, 1, kWritableWaitMs) > 0) { waited = true; continue; }
+            m_stats.dropped += count - next;
+            break;
+        }
+        if (msgDatagrams[0] > 1 && (errno == EINVAL || errno == EIO)) {
+            // GSO rejected (e.g. by the route's device); fall back to one datagram per message
+            m_gso = false;
+            continue;
+        }
+        ++m_stats.sendErrors;
+        m_stats.dropped += msgDatagrams[0];
+        next += msgDatagrams[0];
+    }
+#else
+    uint32_t first = 0;
+    for (uint32_t end : m_queueEnd) {
+        sendOne(m_queue.data() + first, end - first);
+        first = end;
+    }
+#endif
+    m_queue.clear();
+    m_queueEnd.clear();
+}
+
+void UdpPublisher::close() {
+    std::lock_guard<std::mutex> lk(m_mtx);
+    if (m_sock >= 0) {
+        flushLocked();
+        ::close(m_sock);
+        m_sock = -1;
+    }
+}
+
+#endif
+
+bool UdpPublisher::applyOptions(const UdpOptions& options) {
+#ifdef _WIN32
+    using OptPtr = const char*;
+#else
+    using OptPtr = const void*;
+#endif
+    if (options.sendBufferBytes > 0)
+        ::setsockopt(m_sock, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<OptPtr>(&options.sendBufferBytes),
+                     sizeof(options.sendBufferBytes));
+    if (!IN_MULTICAST(ntohl(m_addr.sin_addr.s_addr))) return true;
+    // Multicast destination: hop limit and outgoing interface
+    int ttl = options.multicastTtl;
+    if (::setsockopt(m_sock, IPPROTO_IP, IP_MULTICAST_TTL, reinterpret_cast<OptPtr>(&ttl), sizeof(ttl)) != 0)
+        return false;
+    if (!options.multicastInterface.empty()) {
+        in_addr iface{};
+        if (::inet_pton(AF_INET, options.multicastInterface.c_str(), &iface) != 1) return false;
+        if (::setsockopt(m_sock, IPPROTO_IP, IP_MULTICAST_IF, reinterpret_cast<OptPtr>(&iface), sizeof(iface)) != 0)
+            return false;
+    }
+    return true;
+}
+
+bool UdpPublisher::send(const std::string& payload) {
+    std::lock_guard<std::mutex> lk(m_mtx);
+    flushLocked(); // keep ordering with queued datagrams
+    return sendOne(payload.data(), payload.size());
+}
+
+bool UdpPublisher::enqueue(const std::string& payload) {
+    std::lock_guard<std::mutex> lk(m_mtx);
+    m_queue.insert(m_queue.end(), payload.begin(), payload.end());
+    m_queueEnd.push_back(static_cast<uint32_t>(m_queue.size()));
+    if (m_queueEnd.size() >= kMaxBatch) flushLocked();
+    return true;
+}
+
+void UdpPublisher::flush() {
+    std::lock_guard<std::mutex> lk(m_mtx);
+    flushLocked();
+}
+
+UdpStats UdpPublisher::stats() const {
+    std::lock_guard<std::mutex> lk(m_mtx);
+    return m_stats;
+}
+
 } // namespace ddc
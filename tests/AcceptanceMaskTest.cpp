@@ -0,0 +1,97 @@
+// Pre-parse acceptance filter in the replay and simulation loops.
+#include "Tests.hpp"
+#include "Synthetic.hpp"
+#include "Config.hpp"
+#include "AcceptanceMask.hpp"
+#include "ExtractionEngine.hpp"
+#include "RawRecorder.hpp"
+#include "BusSimulator.hpp"
+#include "B1553Monitor.hpp"
+#include "ExtractionPlan.hpp"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace ddc {
+
+// Pre-parse acceptance filter: replaying mixed traffic or simulating it, only keys with fields
+// reach the callback and every message is counted once; also the cost of a dropped message.
+bool checkAcceptance(size_t count) {
+    std::string err;
+    std::string path = (std::filesystem::temp_directory_path() / "ddc_bench_accept.r1553").string();
+    auto fail = [&](const char* what) {
+        std::cerr << "acceptance: " << what << (err.empty() ? "" : ": ") << err << "\n";
+        std::filesystem::remove(path);
+        return false;
+    };
+    AppConfig cfg = makeConfig(100, 20);
+    auto msgs = makeMessages(cfg, count); // every 4th message on a key without fields
+    ExtractionEngine engine(cfg);
+    const AcceptanceMask mask = AcceptanceMask::fromPlan(engine.plan());
+    if (mask.keyCount() != 20 || mask.all() || !AcceptanceMask().all()) return fail("mask keys");
+    if (mask.subaddressMask(1, false) != 1u << 1 || mask.subaddressMask(1, true) != 0) return fail("subaddress mask");
+    RawRecorder recorder;
+    if (!recorder.open(path, err)) return fail("open for write");
+    for (const auto& m : msgs) recorder.record(m);
+    recorder.close();
+
+    // Returns ns per replayed message
+    auto replay = [&](const AcceptanceMask* filter, size_t& delivered, bool& onlyAccepted, B1553Monitor& monitor) {
+        delivered = 0;
+        onlyAccepted = true;
+        if (!monitor.enableReplay(path, 0.0, err)) return -1.0;
+        if (filter) monitor.setAcceptance(*filter);
+        auto start = std::chrono::steady_clock::now();
+        monitor.start([&](const Raw1553Message& r) {
+            ++delivered;
+            if (filter && !filter->acceptsKey(msgKeyIndex(r.rtAddress, r.subAddress, r.tx))) onlyAccepted = false;
+        });
+        while (!monitor.finished()) std::this_thread::yield();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        monitor.stop();
+        return ns / static_cast<double>(count);
+    };
+    size_t delivered = 0;
+    bool onlyAccepted = true;
+    B1553Monitor all, filtered;
+    double allNs = replay(nullptr, delivered, onlyAccepted, all);
+    if (allNs < 0) return fail("replay");
+    if (delivered != count || all.accepted() != count || all.filtered() != 0) return fail("unfiltered counts");
+    double filteredNs = replay(&mask, delivered, onlyAccepted, filtered);
+    if (delivered != count - count / 4 || !onlyAccepted) return fail("filtered traffic delivered");
+    if (filtered.accepted() != delivered || filtered.filtered() != count / 4) return fail("filtered counts");
+    // Nothing accepted: the cost of dropping a message (header peek and one bit test)
+    const AcceptanceMask none = AcceptanceMask::fromWords({});
+    B1553Monitor dropAll;
+    double droppedNs = replay(&none, delivered, onlyAccepted, dropAll);
+    if (delivered != 0 || dropAll.filtered() != count) return fail("drop-all counts");
+    std::filesystem::remove(path);
+
+    // Simulation: a filtered entry still takes its bus slots, but never reaches the callback
+    SimScheduleEntry kept, dropped;
+    kept.rt = 1; kept.subAddress = 1; kept.rateHz = 2000; kept.wordCount = 4;
+    dropped.rt = 31; dropped.subAddress = 30; dropped.rateHz = 1000; dropped.wordCount = 4;
+    cfg.simSchedule = {kept, dropped};
+    B1553Monitor sim;
+    sim.enableSimulation(cfg);
+    sim.setAcceptance(mask);
+    std::atomic<uint64_t> simDelivered{0}, simForeign{0};
+    sim.start([&](const Raw1553Message& r) {
+        ++simDelivered;
+        if (!mask.acceptsKey(msgKeyIndex(r.rtAddress, r.subAddress, r.tx))) ++simForeign;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    sim.stop();
+    const uint64_t onBus = sim.simulator()->messages();
+    if (simForeign != 0 || simDelivered == 0 || sim.accepted() != simDelivered ||
+        sim.accepted() + sim.filtered() != onBus || sim.filtered() * 2 != sim.accepted())
+        return fail("simulation filter");
+    std::cout << "acceptance keys=" << mask.keyCount() << " accepted=" << filtered.accepted() << " filtered="
+              << filtered.filtered() << " replay_ns_per_msg all=" << allNs << " filtered=" << filteredNs << " dropped=" << droppedNs << "\n";
+    return true;
+}
+
+} // namespace ddc
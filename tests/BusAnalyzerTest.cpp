@@ -0,0 +1,67 @@
+// Per-key bus schedule analyzer.
+#include "Tests.hpp"
+#include "Config.hpp"
+#include "Metrics.hpp"
+#include "StatsReporter.hpp"
+#include "BusAnalyzer.hpp"
+#include "ExtractionPlan.hpp"
+#include <nlohmann/json.hpp>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ddc {
+
+// Bus analyzer on a synthetic schedule: a 50 Hz key with +-3 us jitter and every 10th
+// message dropped, an unscheduled 1 kHz key without jitter, one late timestamp
+bool checkBusAnalyzer() {
+    auto fail = [](const char* what) { std::cerr << "bus analyzer: " << what << "\n"; return false; };
+    ExpectedRate expected{5, 17, false, 50.0};
+    BusAnalyzer analyzer({expected});
+    const size_t a = msgKeyIndex(5, 17, false), b = msgKeyIndex(10, 1, true);
+    for (uint64_t i = 0; i < 1000; ++i) {
+        if (i % 10 != 9) analyzer.observe(a, 1000000 + i * 20000 + (i % 2 ? 3 : 0));
+        analyzer.observe(b, i * 1000);
+    }
+    analyzer.observe(b, 500); // out of order
+    std::vector<BusAnalyzer::KeyStats> keys;
+    analyzer.snapshot(keys);
+    const auto& ka = keys[a];
+    const auto& kb = keys[b];
+    // The last drop (i = 999) has no message after it, so 99 slots are known missed
+    if (ka.messages != 900 || ka.gaps != 899 || ka.missed != 99 || ka.expectedHz != 50.0) return fail("missed slots");
+    if (ka.minGapUs != 19997 || ka.maxGapUs != 40000) return fail("gap range");
+    if (std::fabs(ka.rateHz() - 899e6 / (998 * 20000)) > 1e-9) return fail("rate");
+    // A gap across a drop is measured against its own slot (2 periods): no jitter
+    if (ka.jitter[0] != 99 || ka.jitter[2] != 800) return fail("jitter histogram");
+    if (std::fabs(ka.jitterRmsUs - std::sqrt(800 * 9.0 / 899)) > 1e-9) return fail("jitter rms");
+    if (kb.messages != 1001 || kb.gaps != 999 || kb.outOfOrder != 1 || kb.jitter[0] != 998 || kb.missed != 0)
+        return fail("unscheduled key");
+    if (std::fabs(kb.rateHz() - 1000.0) > 1e-9 || kb.expectedHz != 0) return fail("unscheduled rate");
+    if (BusAnalyzer::jitterBin(0) != 0 || BusAnalyzer::jitterBin(1) != 1 || BusAnalyzer::jitterBin(3) != 2 ||
+        BusAnalyzer::jitterBin(~0ull) != BusAnalyzer::kJitterBins - 1)
+        return fail("jitter bins");
+
+    // Published as "bus_stats" after the key_stats datagrams
+    Metrics metrics;
+    StatsReporter reporter(metrics, nullptr);
+    reporter.setBusAnalyzer(&analyzer);
+    std::vector<std::string> datagrams;
+    reporter.build(datagrams, {});
+    auto bus = nlohmann::json::parse(datagrams.back());
+    if (bus["type"] != "bus_stats" || bus["keys"].size() != 2) return fail("bus_stats datagram");
+    const auto& j = bus["keys"][0];
+    if (j["rt"] != 5 || j["sa"] != 17 || j["tr"] != "R" || j["missed"] != 99 || j["expected_hz"] != 50.0 ||
+        j["jitter_hist"].size() != BusAnalyzer::kJitterBins || j["recent_missed"] != 99)
+        return fail("bus_stats content");
+    for (uint64_t i = 1000; i < 1010; ++i) analyzer.observe(a, 1000000 + i * 20000);
+    reporter.build(datagrams, {});
+    bus = nlohmann::json::parse(datagrams.back());
+    if (bus["keys"][0]["recent_missed"] != 1 || bus["keys"][0]["missed"] != 100 || std::fabs(bus["keys"][0]["recent_rate_hz"].get<double>() - 10e6 / 220000) > 1e-9)
+        return fail("recent counts");
+    if (analyzer.report().find("5-17R: messages 910") == std::string::npos) return fail("report");
+    return true;
+}
+
+} // namespace ddc
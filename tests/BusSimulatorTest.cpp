@@ -0,0 +1,119 @@
+// Bus simulator: schedule rates, field patterns and bus-time pacing.
+#include "Tests.hpp"
+#include "Config.hpp"
+#include "ExtractionEngine.hpp"
+#include "MessageParser.hpp"
+#include "BusSimulator.hpp"
+#include "B1553Monitor.hpp"
+#include "ExtractionPlan.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ddc {
+
+// Schedule rates must come out exact, field patterns must survive extraction to one LSB,
+// an overloaded schedule must drop messages rather than run ahead of its frames, and the
+// paced loop must hold a schedule that fits the bus in real time.
+bool checkSimulator() {
+    AppConfig cfg;
+    StreamConfig sc; sc.name = "sim";
+    auto field = [&](const char* name, uint16_t sa, int first, int last, double scale, const char* type,
+                     const char* pattern, double mn, double mx) {
+        FieldSpec f;
+        f.name = name; f.rt = 5; f.subAddress = sa; f.transmit = false;
+        f.startWord = first; f.endWord = last; f.lsbScale = scale; f.type = type;
+        f.sim.pattern = pattern; f.sim.min = mn; f.sim.max = mx; f.sim.periodSec = 0.25;
+        sc.fields.push_back(f);
+    };
+    field("ramp", 17, 3, 4, std::pow(2.0, -7), "float", "ramp", 0.0, 500.0);
+    field("counter", 17, 5, 5, 1.0, "raw", "counter", 0, 0);
+    field("sine", 22, 9, 9, std::pow(2.0, -5), "signed", "sine", -100.0, 100.0);
+    field("random", 22, 12, 13, 1.0, "ieee754", "random", -5.0, 5.0);
+    sc.fields.push_back(sc.fields[1]);
+    sc.fields.back().name = "bit"; sc.fields.back().startWord = sc.fields.back().endWord = 6;
+    sc.fields.back().singleBit = true; sc.fields.back().bit = 2;
+    cfg.streams.push_back(sc);
+    auto entry = [](uint16_t rt, uint16_t sa, bool tx, uint16_t words, double rate, uint8_t channels) {
+        SimScheduleEntry e; e.rt = rt; e.subAddress = sa; e.transmit = tx; e.wordCount = words;
+        e.rateHz = rate; e.channels = channels; return e;
+    };
+    cfg.simSchedule = {entry(5, 17, false, 16, 200, 0x3), entry(5, 22, false, 16, 100, 0x2),
+                       entry(10, 1, true, 1, 8000, 0x1), entry(7, 3, false, 4, 3, 0x1)};
+    cfg.simMinorFrameHz = 1000;
+
+    auto fail = [](const char* what) { std::cerr << "simulator: " << what << "\n"; return false; };
+    BusSimulator sim(cfg);
+    std::vector<Raw1553Message> out;
+    for (int f = 0; f < 1000; ++f) sim.nextFrame(out); // one simulated second
+    std::unordered_map<uint32_t, size_t> perKey;
+    for (const auto& m : out) ++perKey[static_cast<uint32_t>(msgKeyIndex(m.rtAddress, m.subAddress, m.tx))];
+    if (perKey[msgKeyIndex(5, 17, false)] != 200 || perKey[msgKeyIndex(5, 22, false)] != 100 ||
+        perKey[msgKeyIndex(10, 1, true)] != 8000 || perKey[msgKeyIndex(7, 3, false)] != 3)
+        return fail("schedule rates");
+    if (out.front().timestamp != 0 || sim.busLoad() >= 1.0 || sim.overflowed() != 0) return fail("bus timing");
+
+    MessageParser parser;
+    ExtractionEngine engine(cfg);
+    std::vector<FieldValue> buf(engine.maxValuesPerMessage());
+    uint64_t lastTs = 0, sent17 = 0, sent22 = 0;
+    for (const auto& m : out) {
+        if (m.timestamp < lastTs) return fail("timestamps not monotonic");
+        lastTs = m.timestamp;
+        if (m.rtAddress != 5) continue;
+        bool is17 = m.subAddress == 17;
+        if (m.channel != (is17 ? (sent17 & 1) : 1)) return fail("channel");
+        ParsedMessage p;
+        parser.parse(m, p);
+        size_t n = engine.extract(p, buf.data(), buf.size());
+        double t = static_cast<double>(m.timestamp) / 1e6;
+        for (size_t i = 0; i < n; ++i) {
+            const auto& name = engine.fieldName(buf[i].fieldId);
+            double v = buf[i].value, expected = v, tol = 0;
+            if (name == "ramp") { double ph = t / 0.25; expected = 500.0 * (ph - std::floor(ph)); tol = std::pow(2.0, -8); }
+            else if (name == "counter") expected = static_cast<double>(sent17 & 0xFFFF);
+            else if (name == "bit") expected = static_cast<double>(sent17 & 1);
+            else if (name == "sine") { expected = 100.0 * std::sin(6.283185307179586 * t / 0.25); tol = std::pow(2.0, -6); }
+            else if (name == "random" && (v < -5.0 || v > 5.0)) return fail("random out of range");
+            if (std::fabs(v - expected) > tol) {
+                std::cerr << "simulator: " << name << " = " << v << ", expected " << expected << "\n";
+                return false;
+            }
+        }
+        ++(is17 ? sent17 : sent22);
+    }
+
+    // Overloaded: 50k msg/s needs ~3.7 buses; the excess is dropped and bus time keeps up with frames
+    AppConfig over;
+    over.simSchedule = {entry(3, 1, true, 1, 40000, 0x3), entry(4, 2, false, 2, 10000, 0x1)};
+    BusSimulator overSim(over);
+    out.clear();
+    for (int f = 0; f < 1000; ++f) overSim.nextFrame(out);
+    if (overSim.scheduledLoad() < 1.0 || overSim.overflowed() == 0 || overSim.busLoad() > 1.0 ||
+        out.back().timestamp > 1001000 || out.size() + overSim.overflowed() != 50000)
+        return fail("overloaded schedule");
+
+    // Real time: 12k msg/s (88% of the bus) in 1 kHz bursts for half a second
+    AppConfig fast;
+    fast.simSchedule = {entry(3, 1, true, 1, 10000, 0x3), entry(4, 2, false, 2, 2000, 0x1)};
+    B1553Monitor monitor;
+    monitor.enableSimulation(fast);
+    std::atomic<uint64_t> received{0};
+    auto t0 = std::chrono::steady_clock::now();
+    monitor.start([&](const Raw1553Message&) { received.fetch_add(1, std::memory_order_relaxed); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    monitor.stop();
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    double rate = static_cast<double>(received.load()) / sec;
+    std::cout << "simulator scheduled_msgs_per_sec=" << monitor.simulator()->messagesPerSecond()
+              << " achieved_msgs_per_sec=" << rate << " late_frames=" << monitor.simLateFrames()
+              << " bus_load=" << monitor.simulator()->busLoad() << "\n";
+    if (rate < 0.9 * 12000 || monitor.simulator()->overflowed() != 0) return fail("real-time rate");
+    return true;
+}
+
+} // namespace ddc
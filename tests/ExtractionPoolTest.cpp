@@ -0,0 +1,60 @@
+// Extraction worker pool: same results as one engine, per-key order kept.
+#include "Tests.hpp"
+#include "Synthetic.hpp"
+#include "Config.hpp"
+#include "ExtractionEngine.hpp"
+#include "ExtractionPool.hpp"
+#include "MessageParser.hpp"
+#include "ExtractionPlan.hpp"
+#include "LatestValueStore.hpp"
+#include <iostream>
+#include <vector>
+
+namespace ddc {
+
+// The pool must end with the same store as one sequential engine and hand on every key's
+// values in arrival order (keys interleave freely between workers).
+bool checkPool(size_t workers) {
+    auto fail = [](const char* what) { std::cerr << "pool: " << what << "\n"; return false; };
+    AppConfig cfg = makeConfig(1000, 100);
+    auto raws = makeMessages(cfg, 40000);
+    for (size_t i = 0; i < raws.size(); ++i) raws[i].dataWordCount = static_cast<uint16_t>(1 + i % 32); // some fields miss
+
+    ExtractionEngine sequential(cfg);
+    MessageParser parser;
+    ParsedMessage p;
+    std::vector<FieldValue> buf(sequential.maxValuesPerMessage());
+    std::vector<std::vector<FieldValue>> expected(sequential.fieldCount()), got(sequential.fieldCount());
+    for (const auto& r : raws) {
+        if (!parser.parse(r, p)) continue;
+        size_t n = sequential.extract(p, buf.data(), buf.size());
+        for (size_t i = 0; i < n; ++i) expected[buf[i].fieldId].push_back(buf[i]);
+    }
+
+    ExtractionEngine engine(cfg);
+    ExtractionPool pool(engine, workers, 1024, true);
+    pool.start([&](const FieldValue* values, size_t count, uint64_t) {
+        for (size_t i = 0; i < count; ++i) got[values[i].fieldId].push_back(values[i]);
+    });
+    size_t dispatched = 0;
+    for (const auto& r : raws) dispatched += pool.dispatch(r);
+    pool.stop();
+    if (dispatched != raws.size() - raws.size() / 4 || pool.processedTotal() != dispatched) return fail("dispatch count");
+
+    for (size_t id = 0; id < expected.size(); ++id) {
+        if (got[id].size() != expected[id].size()) return fail("value count");
+        for (size_t i = 0; i < got[id].size(); ++i)
+            if (got[id][i].timestamp != expected[id][i].timestamp || !sameValue(got[id][i].value, expected[id][i].value))
+                return fail("per-key order");
+    }
+    ValueSnapshot a, b;
+    sequential.snapshot(a);
+    engine.snapshot(b);
+    for (size_t id = 0; id < a.values.size(); ++id)
+        if (a.valid[id] != b.valid[id] || a.timestamps[id] != b.timestamps[id] || !sameValue(a.values[id], b.values[id]))
+            return fail("final snapshot");
+    std::cout << "pool workers=" << workers << " messages=" << dispatched << " ok\n";
+    return true;
+}
+
+} // namespace ddc
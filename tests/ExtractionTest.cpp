@@ -0,0 +1,30 @@
+// Extraction: extract() into a reused buffer stays off the heap.
+#include "Tests.hpp"
+#include "AllocCounter.hpp"
+#include "Synthetic.hpp"
+#include "Config.hpp"
+#include "ExtractionEngine.hpp"
+#include "ExtractionPlan.hpp"
+#include <iostream>
+#include <vector>
+
+namespace ddc {
+
+// extract() into a reused buffer must not touch the heap once warmed up.
+bool checkSteadyStateAllocations(size_t fieldCount, size_t keyCount) {
+    AppConfig cfg = makeConfig(fieldCount, keyCount);
+    auto raws = makeMessages(cfg, 1024);
+    auto msgs = parseAll(raws);
+    ExtractionEngine engine(cfg);
+    std::vector<FieldValue> buf(engine.maxValuesPerMessage());
+    size_t values = 0;
+    for (const auto& m : msgs) values += engine.extract(m, buf.data(), buf.size()); // warm-up
+    uint64_t before = g_allocCount.load();
+    for (const auto& m : msgs) values += engine.extract(m, buf.data(), buf.size());
+    uint64_t allocs = g_allocCount.load() - before;
+    std::cout << "alloc fields=" << fieldCount << " messages=" << msgs.size()
+              << " values=" << values << " allocations=" << allocs << "\n";
+    return allocs == 0;
+}
+
+} // namespace ddc
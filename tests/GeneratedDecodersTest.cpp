@@ -0,0 +1,61 @@
+// Generated field decoders against the DecodeOp table.
+#include "Tests.hpp"
+#include "Synthetic.hpp"
+#include "Config.hpp"
+#include "ExtractionEngine.hpp"
+#include "GeneratedDecoders.hpp"
+#include "ExtractionPlan.hpp"
+#include "LatestValueStore.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ddc {
+
+// Generated decoders against the DecodeOp table for the config they were built from:
+// identical values, ids, names and latest values; any other config keeps the table.
+bool checkGenerated() {
+    auto fail = [](const char* what) { std::cerr << "generated decoders: " << what << "\n"; return false; };
+    std::string err;
+    auto cfg = ConfigLoader::loadFromFile(DDC_DECODER_CONFIG, err);
+    if (!cfg) return fail(err.c_str());
+    const GeneratedDecoders* g = generatedDecoders();
+    AppConfig tableCfg = *cfg;
+    tableCfg.generatedDecoders = false;
+    ExtractionEngine generated(*cfg), table(tableCfg);
+    if (!g || generated.generated() != g || table.generated()) return fail("backend selection");
+    if (g->fieldCount != table.fieldCount()) return fail("field count");
+    for (uint32_t id = 0; id < g->fieldCount; ++id)
+        if (table.fieldName(id) != g->fieldNames[id]) return fail("field names");
+
+    auto raws = makeKeyTraffic(*cfg, 32 * 64, true);
+    auto msgs = parseAll(raws);
+    std::vector<FieldValue> a(table.maxValuesPerMessage()), b(table.maxValuesPerMessage());
+    size_t values = 0;
+    for (const auto& m : msgs) {
+        size_t n = generated.extract(m, a.data(), a.size()), k = table.extract(m, b.data(), b.size());
+        if (n != k) return fail("value count");
+        for (size_t i = 0; i < n; ++i)
+            if (a[i].fieldId != b[i].fieldId || a[i].timestamp != b[i].timestamp || !sameValue(a[i].value, b[i].value))
+                return fail("values differ");
+        values += n;
+    }
+    ValueSnapshot sa, sb;
+    generated.snapshot(sa);
+    table.snapshot(sb);
+    if (sa.valid != sb.valid || sa.timestamps != sb.timestamps) return fail("snapshot");
+    for (size_t id = 0; id < sa.values.size(); ++id)
+        if (!sameValue(sa.values[id], sb.values[id])) return fail("snapshot values");
+
+    // A field edited at run time (or by a reload) falls back to the table
+    AppConfig edited = *cfg;
+    if (!edited.streams.empty() && !edited.streams.front().fields.empty()) {
+        edited.streams.front().fields.front().lsbScale *= 2;
+        if (ExtractionEngine(edited).generated()) return fail("used for a different config");
+    }
+    std::cout << "generated decoders: " << g->fieldCount << " fields from " << g->source << ", " << values
+              << " values identical to the table\n";
+    return true;
+}
+
+} // namespace ddc
@@ -0,0 +1,56 @@
+// Latency histograms: bucket precision, percentiles and merged shards.
+#include "Tests.hpp"
+#include "LatencyStats.hpp"
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+namespace ddc {
+
+// Percentiles within the bucket precision, shards merged, and a reader racing the writers.
+bool checkLatencyStats() {
+    auto fail = [](const char* what) { std::cerr << "latency: " << what << "\n"; return false; };
+    for (uint64_t v : {0ull, 1ull, 31ull, 32ull, 33ull, 1000ull, 123456789ull, 1ull << 40, 1ull << 41,
+                       (1ull << 42) - 1, 1ull << 42, ~0ull}) {
+        size_t b = LatencyHistogram::bucketOf(v);
+        if (b >= LatencyHistogram::kBucketCount) return fail("bucket range");
+        if (v < (1ull << 42) && std::fabs(LatencyHistogram::bucketValue(b) - static_cast<double>(v)) > 0.032 * static_cast<double>(v) + 0.5)
+            return fail("bucket precision");
+    }
+    // The top exponent fills the last bucket exactly; anything above saturates there
+    if (LatencyHistogram::bucketOf((1ull << 42) - 1) != LatencyHistogram::kBucketCount - 1 ||
+        LatencyHistogram::bucketOf(1ull << 42) != LatencyHistogram::kBucketCount - 1 ||
+        LatencyHistogram::bucketOf(1ull << 41) != LatencyHistogram::kBucketCount - LatencyHistogram::kSubCount)
+        return fail("bucket saturation");
+    // 1..100000 ns uniformly over two shards
+    LatencyStats stats;
+    auto a = stats.addShard("a"), b = stats.addShard("b");
+    for (uint64_t v = 1; v <= 100000; ++v) (v % 2 ? a : b)->record(LatencyStage::Parse, v);
+    LatencySummary s = stats.summary(LatencyStage::Parse);
+    auto near = [](double got, double want) { return std::fabs(got - want) <= 0.032 * want; };
+    if (s.count != 100000 || !near(s.p50Us, 50.0) || !near(s.p99Us, 99.0) || !near(s.p999Us, 99.9) || s.maxUs != 100.0 ||
+        !near(s.meanUs, 50.0)) {
+        std::cerr << stats.report();
+        return fail("percentiles");
+    }
+    if (stats.summary(LatencyStage::Send).count != 0) return fail("empty stage");
+
+    std::atomic<bool> done{false};
+    auto c = stats.addShard("c");
+    std::thread writer([&] {
+        for (uint64_t i = 0; i < 2000000; ++i) c->record(LatencyStage::Extract, 100 + i % 1000);
+        done = true;
+    });
+    uint64_t last = 0;
+    while (!done.load()) {
+        uint64_t n = stats.summary(LatencyStage::Extract).count;
+        if (n < last) { writer.join(); return fail("count went backwards"); }
+        last = n;
+    }
+    writer.join();
+    if (stats.summary(LatencyStage::Extract).count != 2000000) return fail("racing count");
+    return true;
+}
+
+} // namespace ddc
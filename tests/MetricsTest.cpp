@@ -0,0 +1,75 @@
+// Pipeline counters and the stats report.
+#include "Tests.hpp"
+#include "LatencyStats.hpp"
+#include "Metrics.hpp"
+#include "StatsReporter.hpp"
+#include "ExtractionPlan.hpp"
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ddc {
+
+// Counter shards sum exactly, per-key totals follow message(), a reader racing a writer
+// never sees a total go backwards, and a report splits keys over datagrams.
+bool checkMetrics() {
+    auto fail = [](const char* what) { std::cerr << "metrics: " << what << "\n"; return false; };
+    Metrics metrics;
+    auto a = metrics.addShard(), b = metrics.addShard();
+    a->add(Counter::Captured, 5);
+    b->add(Counter::Captured, 7);
+    a->message(msgKeyIndex(1, 2, true), 4, 4);    // all fields decoded
+    b->message(msgKeyIndex(1, 2, true), 4, 1);    // short message: 3 bounds misses
+    b->message(msgKeyIndex(3, 4, false), 0, 0);   // no fields on the key
+    std::vector<Metrics::KeyTotals> keys;
+    metrics.keyTotals(keys);
+    if (metrics.total(Counter::Captured) != 12) return fail("shard sum");
+    if (metrics.total(Counter::Extracted) != 2 || metrics.total(Counter::Values) != 5 ||
+        metrics.total(Counter::BoundsMisses) != 3 || metrics.total(Counter::Unmatched) != 1)
+        return fail("message counters");
+    if (keys.size() != kMsgKeySpace || keys[msgKeyIndex(1, 2, true)].messages != 2 ||
+        keys[msgKeyIndex(1, 2, true)].boundsMisses != 3 || keys[msgKeyIndex(3, 4, false)].messages != 1)
+        return fail("key totals");
+
+    std::atomic<bool> done{false};
+    auto c = metrics.addShard();
+    std::thread writer([&] {
+        for (uint64_t i = 0; i < 2000000; ++i) c->add(Counter::Processed);
+        done = true;
+    });
+    uint64_t last = 0;
+    while (!done.load()) {
+        uint64_t n = metrics.total(Counter::Processed);
+        if (n < last) { writer.join(); return fail("total went backwards"); }
+        last = n;
+    }
+    writer.join();
+    if (metrics.total(Counter::Processed) != 2000000) return fail("racing total");
+
+    // 301 active keys (one from above): one stats datagram plus key_stats of 256 + 45
+    for (uint16_t rt = 0; rt < 10; ++rt)
+        for (uint16_t sa = 0; sa < 30; ++sa) c->message(msgKeyIndex(rt, sa, false), 1, 1);
+    LatencyStats latency;
+    latency.addShard("x")->record(LatencyStage::Parse, 1000);
+    StatsReporter reporter(metrics, &latency);
+    std::vector<std::string> datagrams;
+    reporter.build(datagrams, [](nlohmann::json& j) { j["extra"] = 1; });
+    if (datagrams.size() != 3) return fail("datagram split");
+    auto stats = nlohmann::json::parse(datagrams[0]);
+    if (stats["type"] != "stats" || stats["counters"]["processed"] != 2000000 || stats["extra"] != 1 ||
+        stats["latency"]["parse"]["count"] != 1 || stats["latency"].contains("send"))
+        return fail("stats datagram");
+    size_t reported = 0;
+    for (size_t i = 1; i < datagrams.size(); ++i) {
+        auto k = nlohmann::json::parse(datagrams[i]);
+        if (k["type"] != "key_stats" || k["seq"] != 0) return fail("key_stats datagram");
+        reported += k["keys"].size();
+    }
+    if (reported != 301 || reporter.reports() != 1) return fail("key_stats count");
+    return true;
+}
+
+} // namespace ddc
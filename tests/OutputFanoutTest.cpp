@@ -0,0 +1,164 @@
+// Output fan-out to several local sinks.
+#include "Tests.hpp"
+#include "Synthetic.hpp"
+#include "Config.hpp"
+#include "ExtractionEngine.hpp"
+#include "BinaryDecoder.hpp"
+#include "OutputFanout.hpp"
+#include "ExtractionPlan.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace ddc {
+
+// Fan-out to local receivers: sinks with identical settings share one encoded payload,
+// stream selection filters fields and each immediate group has a gap-free seq.
+bool checkFanout(bool tryMulticast) {
+    struct Receiver {
+        int fd{-1};
+        uint16_t port{};
+        std::vector<std::string> datagrams;
+    };
+    auto openReceiver = [](Receiver& r, const char* group) {
+        r.fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+        int rcvbuf = 4 << 20;
+        ::setsockopt(r.fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(group ? INADDR_ANY : INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (::bind(r.fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            ::getsockname(r.fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) return false;
+        r.port = ntohs(addr.sin_port);
+        ::fcntl(r.fd, F_SETFL, ::fcntl(r.fd, F_GETFL, 0) | O_NONBLOCK);
+        if (!group) return true;
+        ip_mreq mreq{};
+        ::inet_pton(AF_INET, group, &mreq.imr_multiaddr);
+        mreq.imr_interface.s_addr = htonl(INADDR_LOOPBACK);
+        return ::setsockopt(r.fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) == 0;
+    };
+    auto drain = [](Receiver& r) {
+        char buf[65536];
+        for (;;) {
+            ssize_t n = ::recv(r.fd, buf, sizeof(buf), 0);
+            if (n < 0) break;
+            r.datagrams.emplace_back(buf, static_cast<size_t>(n));
+        }
+    };
+
+    // Two streams: s1 = first half of the fields, s2 = the rest
+    AppConfig cfg = makeConfig(20, 4);
+    StreamConfig s1 = cfg.streams.front(), s2 = cfg.streams.front();
+    s1.name = "s1"; s1.fields.resize(10);
+    s2.name = "s2"; s2.fields.erase(s2.fields.begin(), s2.fields.begin() + 10);
+    cfg.streams = {s1, s2};
+
+    const char* group = "239.255.77.1";
+    std::vector<Receiver> rx(6);
+    bool multicast = tryMulticast;
+    for (size_t i = 0; i < rx.size(); ++i) {
+        if (i == 5 && !multicast) break;
+        if (!openReceiver(rx[i], i == 5 ? group : nullptr)) {
+            if (i != 5) { std::cerr << "fanout: cannot open receiver\n"; return false; }
+            multicast = false; // no multicast route on this host; the unicast sinks are still checked
+        }
+    }
+    auto sink = [](uint16_t port, bool batch, OutputFormat format, std::vector<std::string> streams) {
+        SinkConfig s;
+        s.port = port; s.batch = batch; s.format = format; s.rateHz = 500; s.streams = std::move(streams);
+        return s;
+    };
+    cfg.sinks = {
+        sink(rx[0].port, true, OutputFormat::Json, {}),
+        sink(rx[1].port, true, OutputFormat::Json, {"s1", "s2"}), // same field set as "all"
+        sink(rx[2].port, true, OutputFormat::Json, {"s1"}),
+        sink(rx[3].port, false, OutputFormat::Binary, {"s2"}),
+        sink(rx[4].port, false, OutputFormat::Json, {}),
+    };
+    if (multicast) {
+        SinkConfig m = sink(rx[5].port, false, OutputFormat::Json, {});
+        m.host = group;
+        m.multicastTtl = 0;
+        m.multicastInterface = "127.0.0.1";
+        cfg.sinks.push_back(m);
+    }
+
+    auto raws = makeMessages(cfg, 256);
+    auto msgs = parseAll(raws);
+    ExtractionEngine engine(cfg);
+    std::vector<FieldValue> buf(engine.maxValuesPerMessage());
+    OutputFanout fanout(cfg, engine);
+    std::string err;
+    if (!fanout.open(err)) {
+        if (!multicast) { std::cerr << "fanout: " << err << "\n"; return false; }
+        // Multicast send not permitted here: retry without the multicast sink
+        for (auto& r : rx) if (r.fd >= 0) ::close(r.fd);
+        return checkFanout(false);
+    }
+    size_t expectedGroups = 4;
+    if (fanout.groupCount() != expectedGroups) { std::cerr << "fanout: unexpected group count\n"; return false; }
+    fanout.start();
+    size_t allValues = 0, s2Values = 0;
+    for (size_t i = 0; i < msgs.size(); ++i) {
+        size_t n = engine.extract(msgs[i], buf.data(), buf.size());
+        fanout.publish(buf.data(), n);
+        allValues += n;
+        for (size_t k = 0; k < n; ++k) if (buf[k].fieldId >= 10) ++s2Values;
+        if (i % 16 == 15) {
+            fanout.flush();
+            for (auto& r : rx) if (r.fd >= 0) drain(r);
+        }
+    }
+    fanout.flush();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    fanout.stop();
+    for (auto& r : rx) if (r.fd >= 0) { drain(r); ::close(r.fd); }
+
+    auto fail = [](const char* what) { std::cerr << "fanout: " << what << "\n"; return false; };
+    // Shared batch group: identical bytes to both members
+    if (rx[0].datagrams.empty() || rx[0].datagrams != rx[1].datagrams) return fail("shared batch payloads differ");
+    // Stream selection: s1 only
+    std::vector<std::string> s1Tops;
+    for (auto& f : s1.fields) s1Tops.push_back(f.name.substr(0, f.name.find('.')));
+    for (const auto& d : rx[2].datagrams) {
+        auto j = nlohmann::json::parse(d);
+        for (auto it = j.begin(); it != j.end(); ++it) {
+            const std::string& k = it.key();
+            if (k == "timestamp_us" || k == "timestamp" || k == "datetime" || k == "seq") continue;
+            if (std::find(s1Tops.begin(), s1Tops.end(), k) == s1Tops.end()) return fail("s1 sink received other fields");
+        }
+    }
+    // Immediate binary s2: every value, in order, nothing else
+    BinaryDecoder decoder;
+    DecodedFrame frame;
+    for (const auto& d : rx[3].datagrams)
+        decoder.feed(reinterpret_cast<const uint8_t*>(d.data()), d.size(), frame);
+    size_t decoded = 0;
+    for (const auto& d : rx[3].datagrams) {
+        if (decoder.feed(reinterpret_cast<const uint8_t*>(d.data()), d.size(), frame) != BinaryDecoder::Result::Data) continue;
+        if (frame.seq != decoded || frame.values.size() != 1 || frame.values[0].fieldId < 10) return fail("binary s2 sink");
+        ++decoded;
+    }
+    if (decoded != s2Values) return fail("binary s2 sink lost values");
+    // Immediate JSON: every value once, seq gap-free; multicast member sees the same bytes
+    if (rx[4].datagrams.size() != allValues) return fail("immediate sink lost values");
+    for (size_t i = 0; i < rx[4].datagrams.size(); ++i)
+        if (nlohmann::json::parse(rx[4].datagrams[i])["seq"].get<uint64_t>() != i) return fail("immediate seq gap");
+    if (multicast && rx[5].datagrams != rx[4].datagrams) return fail("multicast member differs");
+    std::cout << "fanout sinks=" << fanout.sinkCount() << " groups=" << fanout.groupCount()
+              << " batch_ticks=" << rx[0].datagrams.size() << " immediate_values=" << allValues
+              << " binary_s2_values=" << decoded << " multicast=" << (multicast ? "ok" : "skipped") << "\n";
+    return true;
+}
+
+} // namespace ddc
@@ -0,0 +1,60 @@
+// Deadline scheduler for per-stream batch rates.
+#include "Tests.hpp"
+#include "Synthetic.hpp"
+#include "Config.hpp"
+#include "ExtractionEngine.hpp"
+#include "OutputFanout.hpp"
+#include "RateScheduler.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+namespace ddc {
+
+// Tick counts follow elapsed time exactly (no drift), and an entry slowed past its period
+// skips ticks instead of bursting. Also checks that stream rates split a batch sink.
+bool checkRateScheduler() {
+    auto fail = [](const char* what) { std::cerr << "rate scheduler: " << what << "\n"; return false; };
+    RateScheduler scheduler;
+    const double rates[] = {1000, 200, 3, 100};
+    for (double r : rates) scheduler.add(r);
+    std::atomic<bool> running{true};
+    uint64_t slowTicks = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    std::thread stopper([&] { std::this_thread::sleep_for(std::chrono::milliseconds(1000)); running = false; });
+    scheduler.run([&](size_t i) {
+        if (i == 3 && ++slowTicks % 10 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(35));
+    }, running);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    stopper.join();
+    for (size_t i = 0; i < 4; ++i) {
+        auto s = scheduler.stats(i);
+        double due = std::floor(elapsed * rates[i]) + 1;
+        std::cout << "scheduler rate=" << rates[i] << " ticks=" << s.ticks << " missed=" << s.missed
+                  << " lateness_mean_us=" << s.meanLatenessUs << " lateness_max_us=" << s.maxLatenessUs << "\n";
+        // The slow entry also delays the others by up to its sleep
+        if (std::fabs(static_cast<double>(s.ticks + s.missed) - due) > 0.04 * rates[i] + 1) return fail("tick count drifted");
+    }
+    if (scheduler.stats(3).missed == 0) return fail("slow entry did not skip");
+    if (scheduler.stats(2).missed != 0) return fail("slow entry stalled another");
+
+    AppConfig cfg = makeConfig(20, 4);
+    StreamConfig s1 = cfg.streams.front(), s2 = s1, s3 = s1;
+    s1.name = "s1"; s1.fields.resize(5); s1.rateHz = 200;
+    s2.name = "s2"; s2.fields.erase(s2.fields.begin(), s2.fields.begin() + 5); s2.fields.resize(5);
+    s3.name = "s3"; s3.fields.erase(s3.fields.begin(), s3.fields.begin() + 10); s3.rateHz = 200;
+    cfg.streams = {s1, s2, s3};
+    SinkConfig batch; batch.batch = true; batch.rateHz = 10;
+    SinkConfig only2 = batch; only2.streams = {"s2"};
+    cfg.sinks = {batch, only2};
+    ExtractionEngine engine(cfg);
+    OutputFanout fanout(cfg, engine);
+    if (fanout.batchTickCount() != 3 || fanout.batchTickName(0) != "s1,s3" || fanout.batchTickRate(0) != 200 ||
+        fanout.batchTickName(1) != "s2" || fanout.batchTickRate(1) != 10 || fanout.batchTickName(2) != "s2")
+        return fail("stream rate split");
+    return true;
+}
+
+} // namespace ddc
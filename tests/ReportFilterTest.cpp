@@ -0,0 +1,48 @@
+// Deadband and heartbeat reporting.
+#include "Tests.hpp"
+#include "Config.hpp"
+#include "ReportFilter.hpp"
+#include "ExtractionPlan.hpp"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace ddc {
+
+bool checkReportFilter() {
+    auto fail = [](const char* what) { std::cerr << "report filter: " << what << "\n"; return false; };
+    std::vector<FieldSpec> fields(4);
+    fields[1].report.enabled = true;                                   // any change
+    fields[2].report.enabled = true; fields[2].report.deadband = 1.0;
+    fields[2].report.minIntervalMs = 10; fields[2].report.maxIntervalMs = 100;
+    fields[3].report.enabled = true; fields[3].report.deadbandPct = 10.0;
+    ReportFilter filter(fields);
+    auto due = [&](uint32_t id, double value, uint64_t ms) {
+        FieldValue v{id, value, ms * 1000};
+        return filter.apply(&v, 1, &v) == 1;
+    };
+    // {field, value, time ms, expected}
+    const struct { uint32_t id; double value; uint64_t ms; bool due; } steps[] = {
+        {0, 5, 0, true}, {0, 5, 1, true},                                  // no settings: everything
+        {1, 0, 0, true}, {1, 0, 1, false}, {1, 1, 2, true}, {1, 1, 900, false},
+        {1, std::nan(""), 901, true}, {1, std::nan(""), 902, false},
+        {2, 10, 0, true}, {2, 10.5, 20, false}, {2, 11.5, 25, true},       // past the band
+        {2, 20, 30, false},                                                // inside min interval
+        {2, 20, 36, true},                                                 // now due (vs 11.5)
+        {2, 20, 100, false}, {2, 20, 136, true}, {2, 20.9, 236, true},    // heartbeats
+        {3, 100, 0, true}, {3, 109, 1, false}, {3, 111, 2, true}, {3, 100, 3, false}, {3, 99, 3, true},
+        {3, 96, 4, false}, {3, 105, 5, false}, {3, 89, 6, true},         // band tracks the reported value
+    };
+    for (const auto& s : steps)
+        if (due(s.id, s.value, s.ms) != s.due) {
+            std::cerr << "field " << s.id << " value " << s.value << " at " << s.ms << " ms\n";
+            return fail("due");
+        }
+    // Compaction keeps order and only the due values
+    FieldValue batch[] = {{0, 1, 1000000}, {1, 1, 1000000}, {1, 1, 1000001}, {0, 2, 1000002}};
+    if (filter.apply(batch, 4, batch) != 3 || batch[1].fieldId != 1 || batch[2].value != 2) return fail("compaction");
+    return true;
+}
+
+} // namespace ddc
@@ -0,0 +1,72 @@
+// Correctness tests. ctest runs each one by name (see CMakeLists.txt).
+// Usage: ddc_tests [name...]   (no names: run every test)
+#include "Tests.hpp"
+#include <iostream>
+#include <string>
+
+using namespace ddc;
+
+namespace {
+
+struct TestCase {
+    const char* name;
+    bool (*run)();
+};
+
+const TestCase kTests[] = {
+    {"Extraction", [] {
+        if (checkSteadyStateAllocations(100, 20) && checkSteadyStateAllocations(1000, 100)) return true;
+        std::cerr << "extract() allocated in steady state\n";
+        return false;
+    }},
+    {"RawRecording", [] { return checkRecording(200000); }},
+    {"AcceptanceMask", [] { return checkAcceptance(200000); }},
+    {"BusSimulator", [] { return checkSimulator(); }},
+    {"TimestampMerger", [] { return checkMerger(); }},
+    {"ExtractionPool", [] { return checkPool(1) && checkPool(3); }},
+    {"ReportFilter", [] { return checkReportFilter(); }},
+    {"LatestValueStore", [] { return checkAggregation(); }},
+    {"RateScheduler", [] { return checkRateScheduler(); }},
+    {"LatencyStats", [] { return checkLatencyStats(); }},
+    {"Metrics", [] { return checkMetrics(); }},
+    {"BusAnalyzer", [] { return checkBusAnalyzer(); }},
+    {"ConfigReloader", [] { return checkReload(); }},
+#ifdef DDC_DECODER_CONFIG
+    {"GeneratedDecoders", [] { return checkGenerated(); }},
+#endif
+#ifndef _WIN32
+    {"UdpPublisher", [] {
+        if (checkUdpLoopback(20000)) return true;
+        std::cerr << "UDP loopback delivery failed\n";
+        return false;
+    }},
+    {"OutputFanout", [] {
+        if (checkFanout()) return true;
+        std::cerr << "output fan-out check failed\n";
+        return false;
+    }},
+#endif
+};
+
+bool runTest(const TestCase& t) {
+    bool ok = t.run();
+    std::cout << (ok ? "PASS " : "FAIL ") << t.name << std::endl;
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool ok = true;
+    if (argc < 2) {
+        for (const auto& t : kTests) ok = runTest(t) && ok;
+        return ok ? 0 : 1;
+    }
+    for (int i = 1; i < argc; ++i) {
+        const TestCase* found = nullptr;
+        for (const auto& t : kTests) if (argv[i] == std::string(t.name)) found = &t;
+        if (!found) { std::cerr << "unknown test " << argv[i] << "\n"; return 1; }
+        ok = runTest(*found) && ok;
+    }
+    return ok ? 0 : 1;
+}
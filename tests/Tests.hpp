@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+
+// Correctness tests run by ddc_tests, one source file per component. Each prints what
+// went wrong and returns false on failure.
+namespace ddc {
+
+bool checkSteadyStateAllocations(size_t fieldCount, size_t keyCount); // ExtractionTest.cpp
+bool checkRecording(size_t count);                          // RawRecordingTest.cpp
+bool checkAcceptance(size_t count);                         // AcceptanceMaskTest.cpp
+bool checkSimulator();                                      // BusSimulatorTest.cpp
+bool checkMerger();                                         // TimestampMergerTest.cpp
+bool checkPool(size_t workers);                             // ExtractionPoolTest.cpp
+bool checkReportFilter();                                   // ReportFilterTest.cpp
+bool checkAggregation();                                    // LatestValueStoreTest.cpp
+bool checkRateScheduler();                                  // RateSchedulerTest.cpp
+bool checkLatencyStats();                                   // LatencyStatsTest.cpp
+bool checkMetrics();                                        // MetricsTest.cpp
+bool checkBusAnalyzer();                                    // BusAnalyzerTest.cpp
+bool checkReload();                                         // ConfigReloaderTest.cpp
+bool checkGenerated();                                      // GeneratedDecodersTest.cpp
+bool checkUdpLoopback(size_t datagrams);                    // UdpPublisherTest.cpp
+bool checkFanout(bool tryMulticast = true);                 // OutputFanoutTest.cpp
+
+// Bitwise equality, so NaNs (from ieee754 fields) compare equal
+inline bool sameValue(double a, double b) { return std::memcmp(&a, &b, sizeof(a)) == 0; }
+
+} // namespace ddc
@@ -0,0 +1,140 @@
+// Multi-device merge: complete and in timestamp order.
+#include "Tests.hpp"
+#include "Config.hpp"
+#include "BusSimulator.hpp"
+#include "TimestampMerger.hpp"
+#include "B1553Monitor.hpp"
+#include "OverflowPolicy.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace ddc {
+
+// Merged output must be complete and in timestamp order: interleaved sources, a source that
+// goes quiet (window and wall-clock release), and three live simulated devices.
+bool checkMerger() {
+    auto fail = [](const char* what) { std::cerr << "merger: " << what << "\n"; return false; };
+    {
+        TimestampMerger merger(3, 65536, OverflowPolicy::Block, 2000);
+        std::mt19937 rng{7};
+        std::uniform_int_distribution<int> gap(1, 50);
+        for (size_t k = 0; k < 3; ++k) {
+            uint64_t ts = k;
+            for (size_t i = 0; i < 20000; ++i) {
+                Raw1553Message m; m.timestamp = ts += static_cast<uint64_t>(gap(rng)); m.bus = static_cast<uint16_t>(k);
+                merger.push(k, m);
+            }
+        }
+        Raw1553Message m;
+        size_t n = 0;
+        uint64_t last = 0;
+        while (merger.pop(m) || merger.drain(m)) {
+            if (m.timestamp < last) return fail("interleaved order");
+            last = m.timestamp;
+            ++n;
+        }
+        if (n != 60000 || merger.outOfOrder() != 0) return fail("interleaved count");
+    }
+    {
+        TimestampMerger merger(3, 1024, OverflowPolicy::Block, 2000);
+        for (uint64_t ts = 0; ts <= 10000; ts += 100) { Raw1553Message m; m.timestamp = ts; merger.push(0, m); }
+        Raw1553Message m;
+        size_t n = 0;
+        while (merger.pop(m)) ++n;
+        if (n != 81) return fail("window release"); // up to newest - window
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        while (merger.pop(m)) ++n;
+        if (n != 101) return fail("idle release");
+    }
+    {
+        // Live producers, window too long to matter: order rests on the safety rule alone. The
+        // odd source pushes in back-to-back pairs, which land between a failed pop and the
+        // read of its latest timestamp if that read comes second.
+        TimestampMerger merger(2, 1024, OverflowPolicy::Block, 3600000000ull);
+        constexpr uint64_t kPerSource = 200000;
+        std::atomic<size_t> finished{0};
+        std::thread even([&] {
+            for (uint64_t i = 0; i < kPerSource; ++i) { Raw1553Message m; m.timestamp = 2 * i + 2; merger.push(0, m); }
+            ++finished;
+        });
+        std::thread odd([&] {
+            for (uint64_t i = 0; i < kPerSource; i += 2) {
+                Raw1553Message m; m.timestamp = 2 * i + 1; merger.push(1, m);
+                m.timestamp = 2 * i + 3; merger.push(1, m);
+                for (int spin = 0; spin < 64; ++spin) std::atomic_signal_fence(std::memory_order_seq_cst);
+            }
+            ++finished;
+        });
+        Raw1553Message m;
+        uint64_t last = 0, n = 0, disorder = 0;
+        for (;;) {
+            const bool stopped = finished.load() == 2;
+            if (merger.pop(m) || (stopped && merger.drain(m))) {
+                if (m.timestamp < last) ++disorder;
+                last = std::max(last, m.timestamp);
+                ++n;
+            } else if (stopped) break;
+        }
+        even.join();
+        odd.join();
+        if (n != 2 * kPerSource) return fail("racing count");
+        if (disorder != 0 || merger.outOfOrder() != 0) return fail("racing order");
+    }
+
+    AppConfig cfg;
+    auto entry = [](uint16_t rt, double rate, uint16_t words) {
+        SimScheduleEntry e; e.rt = rt; e.subAddress = 1; e.rateHz = rate; e.wordCount = words; return e;
+    };
+    const std::vector<std::vector<SimScheduleEntry>> schedules = {
+        {entry(1, 5000, 2), entry(2, 50, 32)}, {entry(3, 3000, 4)}, {entry(4, 777, 8), entry(5, 100, 1)}};
+    TimestampMerger merger(schedules.size(), 65536, OverflowPolicy::Block, 20000);
+    std::vector<std::unique_ptr<B1553Monitor>> monitors;
+    for (size_t i = 0; i < schedules.size(); ++i) {
+        cfg.simSchedule = schedules[i];
+        monitors.push_back(std::make_unique<B1553Monitor>());
+        monitors.back()->enableSimulation(cfg);
+        monitors.back()->setBus(static_cast<uint16_t>(i));
+    }
+    std::atomic<bool> running{true};
+    std::vector<uint64_t> perBus(schedules.size(), 0);
+    size_t disorder = 0, merged = 0;
+    std::thread consumer([&] {
+        Raw1553Message m;
+        uint64_t last = 0;
+        auto take = [&] {
+            if (m.timestamp < last) ++disorder;
+            last = std::max(last, m.timestamp);
+            if (m.bus < perBus.size()) ++perBus[m.bus];
+            ++merged;
+        };
+        for (;;) {
+            if (merger.pop(m)) { take(); continue; }
+            if (!running.load()) { if (merger.drain(m)) { take(); continue; } break; }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+    auto timeBase = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < monitors.size(); ++i) {
+        monitors[i]->setTimeBase(timeBase);
+        monitors[i]->start([&merger, i](const Raw1553Message& r) { merger.push(i, r); });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    for (auto& mon : monitors) mon->stop();
+    running = false;
+    consumer.join();
+    std::cout << "merge sources=" << monitors.size() << " merged=" << merged << " out_of_order=" << merger.outOfOrder();
+    for (size_t i = 0; i < monitors.size(); ++i) {
+        std::cout << " bus" << i << "=" << perBus[i];
+        if (perBus[i] != monitors[i]->simulator()->messages() || perBus[i] == 0) { std::cout << "\n"; return fail("per-bus count"); }
+    }
+    std::cout << "\n";
+    if (disorder != 0 || merger.outOfOrder() != 0) return fail("live order");
+    return true;
+}
+
+} // namespace ddc
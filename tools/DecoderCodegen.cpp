@@ -0,0 +1,118 @@
+// Generates GeneratedDecoders (include/GeneratedDecoders.hpp) from a config file.
+// Usage: ddc_codegen <config.json> <output.cpp>
+// Run by the build when DDC_GENERATED_DECODERS is ON; the output is rewritten only when
+// its content changes.
+#include "Config.hpp"
+#include "ExtractionPlan.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace ddc;
+
+namespace {
+
+const char* opName(DecodeOpCode op) {
+    switch (op) {
+    case DecodeOpCode::Bit: return "Bit";
+    case DecodeOpCode::Unsigned16: return "Unsigned16";
+    case DecodeOpCode::Signed16: return "Signed16";
+    case DecodeOpCode::UnsignedN: return "UnsignedN";
+    case DecodeOpCode::SignedN: return "SignedN";
+    case DecodeOpCode::Ieee754: return "Ieee754";
+    }
+    return "Unsigned16";
+}
+
+// C++ string literal
+std::string quoted(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') { out += '\\'; out += c; }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8]; std::snprintf(buf, sizeof(buf), "\\%03o", static_cast<unsigned char>(c)); out += buf;
+        } else out += c;
+    }
+    return out + "\"";
+}
+
+// Exact double literal (hex float), so generated values match the table path bit for bit
+std::string hexDouble(double v) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%a", v);
+    return buf;
+}
+
+std::string generate(const ExtractionPlan& plan, const std::string& source) {
+    std::ostringstream o;
+    o << "// Generated by ddc_codegen from " << source << ". Do not edit.\n"
+      << "#include \"GeneratedDecoders.hpp\"\n\n"
+      << "namespace ddc {\n\nnamespace {\n\n"
+      << "using gen::decodeRaw;\n\n";
+
+    o << "constexpr const char* kFieldNames[] = {\n";
+    for (const auto& f : plan.fields()) o << "    " << quoted(f.name) << ",\n";
+    if (plan.fields().empty()) o << "    nullptr,\n";
+    o << "};\n\n";
+
+    for (size_t k = 0; k < kMsgKeySpace; ++k) {
+        const DecodeSlot& slot = plan.slot(k);
+        if (slot.count == 0) continue;
+        o << "// RT " << (k >> 6) << " SA " << ((k >> 1) & 0x1F) << ((k & 1) ? " T" : " R") << "\n"
+          << "inline size_t decodeKey" << k
+          << "(const uint16_t* w, size_t words, uint64_t ts, FieldValue* out) {\n"
+          << "    size_t n = 0;\n";
+        for (const DecodeOp* op = plan.ops() + slot.first; op != plan.ops() + slot.first + slot.count; ++op) {
+            o << "    if (words >= " << unsigned(op->minWords) << ") out[n++] = FieldValue{" << op->fieldId
+              << "u, decodeRaw<DecodeOpCode::" << opName(op->op) << ", " << unsigned(op->wordOffset) << ", "
+              << unsigned(op->wordCount) << ", " << unsigned(op->shift) << ", 0x" << std::hex << op->mask
+              << "ull, 0x" << op->signBit << std::dec << "ull>(w) * " << hexDouble(op->scale) << ", ts};";
+            const std::string& name = plan.fields()[op->fieldId].name;
+            if (name.find_first_of("\\\r\n") == std::string::npos) o << " // " << name;
+            o << "\n";
+        }
+        o << "    return n;\n}\n\n";
+    }
+
+    o << "size_t decode(size_t key, const uint16_t* w, size_t words, uint64_t ts, FieldValue* out) {\n"
+      << "    switch (key) {\n";
+    for (size_t k = 0; k < kMsgKeySpace; ++k)
+        if (plan.slot(k).count) o << "    case " << k << ": return decodeKey" << k << "(w, words, ts, out);\n";
+    o << "    default: return 0;\n    }\n}\n\n"
+      << "constexpr GeneratedDecoders kDecoders{0x" << std::hex << plan.signature() << std::dec << "ull, "
+      << plan.fields().size() << ", kFieldNames, " << quoted(source) << ", decode};\n\n"
+      << "} // namespace\n\n"
+      << "const GeneratedDecoders* generatedDecoders() { return &kDecoders; }\n\n"
+      << "} // namespace ddc\n";
+    return o.str();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: ddc_codegen <config.json> <output.cpp>\n";
+        return 2;
+    }
+    std::string err;
+    auto cfg = ConfigLoader::loadFromFile(argv[1], err);
+    if (!cfg) {
+        std::cerr << "ddc_codegen: " << argv[1] << ": " << err << "\n";
+        return 1;
+    }
+    const std::string code = generate(ExtractionPlan(*cfg), argv[1]);
+    std::ifstream existing(argv[2], std::ios::binary);
+    std::ostringstream current;
+    current << existing.rdbuf();
+    if (existing && current.str() == code) return 0;
+    existing.close();
+    std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+    out << code;
+    if (!out) {
+        std::cerr << "ddc_codegen: cannot write " << argv[2] << "\n";
+        return 1;
+    }
+    return 0;
+}